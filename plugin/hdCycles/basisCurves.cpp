@@ -22,6 +22,7 @@
 #include "config.h"
 #include "material.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/curves.h>
@@ -73,22 +74,28 @@ HdCyclesBasisCurves::HdCyclesBasisCurves(
     static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
     config.enable_motion_blur.eval(m_useMotionBlur, true);
 
+    // The object is added to the scene with its first geometry
     m_cyclesObject = _CreateObject();
-    m_renderDelegate->GetCyclesRenderParam()->AddObject(m_cyclesObject);
 }
 
 HdCyclesBasisCurves::~HdCyclesBasisCurves()
 {
-    if (m_cyclesHair) {
-        m_renderDelegate->GetCyclesRenderParam()->RemoveCurve(m_cyclesHair);
-        delete m_cyclesHair;
-    }
-    if (m_cyclesMesh) {
-        m_renderDelegate->GetCyclesRenderParam()->RemoveMesh(m_cyclesMesh);
-        delete m_cyclesMesh;
-    }
-    if (m_cyclesObject) {
-        m_renderDelegate->GetCyclesRenderParam()->RemoveObject(m_cyclesObject);
+    HdCyclesRenderParam* param = m_renderDelegate->GetCyclesRenderParam();
+
+    param->UnstagePrim(this);
+
+    if (!m_cyclesObject)
+        return;
+
+    // Built by the last Sync but never published
+    if (m_cyclesGeometry && m_cyclesGeometry != m_cyclesObject->geometry)
+        delete m_cyclesGeometry;
+
+    // The render param takes ownership of anything it removes
+    if (m_cyclesObject->geometry) {
+        param->RemoveCurve(m_cyclesObject->geometry);
+        param->RemoveObject(m_cyclesObject);
+    } else {
         delete m_cyclesObject;
     }
 }
@@ -439,15 +446,27 @@ HdCyclesBasisCurves::Sync(HdSceneDelegate* sceneDelegate,
                           HdRenderParam* renderParam, HdDirtyBits* dirtyBits,
                           TfToken const& reprSelector)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesBasisCurves::Sync", GetId());
+
     SdfPath const& id = GetId();
 
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
 
     ccl::Scene* scene = param->GetCyclesScene();
 
+    // Render tag and repr only changes leave the scene as is
+    if (!(*dirtyBits & GetInitialDirtyBitsMask())) {
+        *dirtyBits = HdChangeTracker::Clean;
+        return;
+    }
+
+    // Curves edit their object and geometry in place
+    std::unique_lock<ccl::thread_mutex> sceneLock = param->LockScene();
+
     HdCyclesPDPIMap pdpi;
     bool generate_new_curve = false;
     bool update_curve       = false;
+    uint32_t changes        = HdCyclesRenderParam::NoChanges;
 
     if (*dirtyBits & HdChangeTracker::DirtyPoints) {
         HdCyclesPopulatePrimvarDescsPerInterpolation(sceneDelegate, id, &pdpi);
@@ -530,16 +549,17 @@ HdCyclesBasisCurves::Sync(HdSceneDelegate* sceneDelegate,
             m_curveShape = ccl::CURVE_THICK;
             update_curve = true;
         }
+        changes |= HdCyclesRenderParam::GeometryChanged
+                   | HdCyclesRenderParam::VisibilityChanged;
 
         m_cyclesObject->is_shadow_catcher = _HdCyclesGetCurveParam<bool>(
             dirtyBits, id, this, sceneDelegate,
             usdCyclesTokens->primvarsCyclesObjectIs_shadow_catcher,
             m_cyclesObject->is_shadow_catcher);
 
-        m_cyclesObject->pass_id = _HdCyclesGetCurveParam<bool>(
+        m_passIdPrimvar = _HdCyclesGetCurveParam<int>(
             dirtyBits, id, this, sceneDelegate,
-            usdCyclesTokens->primvarsCyclesObjectPass_id,
-            m_cyclesObject->pass_id);
+            usdCyclesTokens->primvarsCyclesObjectPass_id, m_passIdPrimvar);
 
         m_cyclesObject->use_holdout = _HdCyclesGetCurveParam<bool>(
             dirtyBits, id, this, sceneDelegate,
@@ -599,36 +619,49 @@ HdCyclesBasisCurves::Sync(HdSceneDelegate* sceneDelegate,
     if (*dirtyBits & HdChangeTracker::DirtyVisibility) {
         update_curve        = true;
         _sharedData.visible = sceneDelegate->GetVisible(id);
+        changes |= HdCyclesRenderParam::VisibilityChanged;
     }
 
     if (generate_new_curve) {
-        if (m_cyclesGeometry) {
-            param->RemoveCurve(m_cyclesHair);
-            m_cyclesGeometry->clear();
+        // The object keeps its geometry until CommitStaged, a geometry built
+        // by an earlier Sync and not published yet is replaced
+        if (m_cyclesGeometry && m_cyclesGeometry != m_cyclesObject->geometry)
             delete m_cyclesGeometry;
-        }
+
+        m_cyclesGeometry = nullptr;
+        m_cyclesHair     = nullptr;
+        m_cyclesMesh     = nullptr;
 
         _PopulateCurveMesh(param);
 
         if (m_cyclesGeometry) {
-            m_cyclesObject->geometry = m_cyclesGeometry;
-
             m_cyclesGeometry->compute_bounds();
 
             _PopulateGenerated();
 
-            param->AddCurve(m_cyclesGeometry);
+            param->StagePrim(this);
         }
 
         if (m_useMotionBlur)
             _PopulateMotion();
     }
 
+    if (*dirtyBits
+        & (HdChangeTracker::DirtyPrimID | HdChangeTracker::DirtyPrimvar)) {
+        const int passId = HdCyclesGetPassId(GetPrimId(), m_passIdPrimvar);
+        if (passId != m_cyclesObject->pass_id) {
+            m_cyclesObject->pass_id = passId;
+            update_curve            = true;
+            changes |= HdCyclesRenderParam::VisibilityChanged;
+        }
+    }
+
     if (*dirtyBits & HdChangeTracker::DirtyTransform) {
         m_transformSamples = HdCyclesSetTransform(m_cyclesObject, sceneDelegate,
                                                   id, m_useMotionBlur);
 
         update_curve = true;
+        changes |= HdCyclesRenderParam::TransformChanged;
     }
 
     if (*dirtyBits & HdChangeTracker::DirtyPrimvar) {
@@ -671,18 +704,25 @@ HdCyclesBasisCurves::Sync(HdSceneDelegate* sceneDelegate,
 
             m_cyclesGeometry->used_shaders = m_usedShaders;
             update_curve                   = true;
+            changes |= HdCyclesRenderParam::GeometryChanged;
         }
     }
 
     if (generate_new_curve || update_curve) {
-        m_cyclesHair->curve_shape = m_curveShape;
+        if (m_cyclesHair)
+            m_cyclesHair->curve_shape = m_curveShape;
 
         m_cyclesObject->visibility = m_visibilityFlags;
         if (!_sharedData.visible)
             m_cyclesObject->visibility = 0;
 
-        m_cyclesGeometry->tag_update(scene, true);
+        if (m_cyclesGeometry)
+            m_cyclesGeometry->tag_update(scene, true);
         m_cyclesObject->tag_update(scene);
+
+        if (generate_new_curve)
+            changes |= HdCyclesRenderParam::GeometryChanged;
+        param->MarkChanged(changes);
         param->Interrupt();
     }
 
@@ -1060,6 +1100,29 @@ HdCyclesBasisCurves::_CreateTubeMesh()
     // TODO: Implement texcoords
 }
 
+void
+HdCyclesBasisCurves::CommitStaged(ccl::Scene* scene)
+{
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesBasisCurves::CommitStaged", GetId());
+
+    if (!m_cyclesGeometry || m_cyclesGeometry == m_cyclesObject->geometry)
+        return;
+
+    HdCyclesRenderParam* param = m_renderDelegate->GetCyclesRenderParam();
+
+    // Applied together with the other queued edits of this commit
+    if (m_cyclesObject->geometry)
+        param->RemoveCurve(m_cyclesObject->geometry);
+    else
+        param->AddObject(m_cyclesObject);
+
+    m_cyclesObject->geometry = m_cyclesGeometry;
+    param->AddCurve(m_cyclesGeometry);
+
+    m_cyclesGeometry->tag_update(scene, true);
+    m_cyclesObject->tag_update(scene);
+}
+
 HdDirtyBits
 HdCyclesBasisCurves::GetInitialDirtyBitsMask() const
 {
@@ -1067,7 +1130,7 @@ HdCyclesBasisCurves::GetInitialDirtyBitsMask() const
            | HdChangeTracker::DirtyNormals | HdChangeTracker::DirtyWidths
            | HdChangeTracker::DirtyPrimvar | HdChangeTracker::DirtyTransform
            | HdChangeTracker::DirtyVisibility
-           | HdChangeTracker::DirtyMaterialId;
+           | HdChangeTracker::DirtyMaterialId | HdChangeTracker::DirtyPrimID;
 }
 
 bool
@@ -25,6 +25,7 @@
 #include "hdcycles.h"
 #include "utils.h"
 #include "renderDelegate.h"
+#include "renderParam.h"
 
 #include <util/util_transform.h>
 
@@ -51,7 +52,8 @@ class HdCyclesRenderDelegate;
  * @brief Cycles Basis Curve Rprim mapped to Cycles Basis Curve
  * 
  */
-class HdCyclesBasisCurves final : public HdBasisCurves {
+class HdCyclesBasisCurves final : public HdBasisCurves,
+                                  public HdCyclesStagedPrim {
 public:
     /**
      * @brief Construct a new HdCycles Basis Curve object
@@ -99,6 +101,14 @@ public:
      */
     void Finalize(HdRenderParam* renderParam) override;
 
+    /**
+     * @brief Swap the geometry built in Sync into the object and the
+     * Cycles scene. Called with the scene mutex held.
+     * 
+     * @param scene Cycles scene
+     */
+    void CommitStaged(ccl::Scene* scene) override;
+
 protected:
     /**
      * @brief Initialize the given representation of this Rprim.
@@ -175,6 +185,9 @@ protected:
     ccl::CurveShapeType m_curveShape;
     int m_curveResolution;
 
+    // Authored primvars:cycles:object:pass_id, -1 if not authored
+    int m_passIdPrimvar = -1;
+
     ccl::vector<ccl::Shader *> m_usedShaders;
 
 private:
@@ -213,6 +226,9 @@ private:
     ccl::Object* m_cyclesObject;
     ccl::Mesh* m_cyclesMesh;
     ccl::Hair* m_cyclesHair;
+
+    // Geometry written by Sync, it replaces the geometry of the object in
+    // CommitStaged when a new one was built
     ccl::Geometry* m_cyclesGeometry;
 
     HdCyclesRenderDelegate* m_renderDelegate;
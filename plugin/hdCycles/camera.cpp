@@ -22,6 +22,7 @@
 #include "config.h"
 #include "renderDelegate.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/camera.h>
@@ -156,7 +157,7 @@ void
 HdCyclesCamera::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                      HdDirtyBits* dirtyBits)
 {
-    HD_TRACE_FUNCTION();
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesCamera::Sync", GetId());
     HF_MALLOC_TAG_FUNCTION();
 
     if (!TF_VERIFY(sceneDelegate != nullptr)) {
@@ -437,11 +438,10 @@ HdCyclesCamera::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         SetTransform(m_projMtx);
     }
 
-    if (m_needsUpdate) {
-        m_cyclesCamera->tag_update();
-        m_cyclesCamera->need_update = true;
-        param->Interrupt();
-    }
+    // The render pass writes and tags the scene camera when it is free,
+    // the session may hold the scene mutex for a whole device update
+    if (m_needsUpdate)
+        param->InterruptCamera();
 
     HdCamera::Sync(sceneDelegate, renderParam, dirtyBits);
 
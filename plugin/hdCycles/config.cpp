@@ -89,6 +89,12 @@ TF_DEFINE_ENV_SETTING(HD_CYCLES_ENABLE_LOGGING, false,
 TF_DEFINE_ENV_SETTING(HD_CYCLES_ENABLE_PROGRESS, false,
                       "Enable HdCycles progress reporting");
 
+TF_DEFINE_ENV_SETTING(HD_CYCLES_ENABLE_TRACE, false,
+                      "Write HdCycles sync timings to a Chrome trace file");
+
+TF_DEFINE_ENV_SETTING(HD_CYCLES_TRACE_FILE, "hdcycles_trace.json",
+                      "Path of the HdCycles Chrome trace file");
+
 TF_DEFINE_ENV_SETTING(HD_CYCLES_USE_TILED_RENDERING, false,
                       "Use Tiled Rendering (Experimental)");
 
@@ -111,6 +117,9 @@ HdCyclesConfig::HdCyclesConfig()
     enable_logging  = TfGetEnvSetting(HD_CYCLES_ENABLE_LOGGING);
     enable_progress = TfGetEnvSetting(HD_CYCLES_ENABLE_PROGRESS);
 
+    enable_trace = TfGetEnvSetting(HD_CYCLES_ENABLE_TRACE);
+    trace_file   = TfGetEnvSetting(HD_CYCLES_TRACE_FILE);
+
     up_axis = TfGetEnvSetting(HD_CYCLES_UP_AXIS);
 
     enable_motion_blur = HdCyclesEnvValue<bool>("HD_CYCLES_ENABLE_MOTION_BLUR",
@@ -141,14 +150,32 @@ HdCyclesConfig::HdCyclesConfig()
                                                    "SVM");
     display_buffer_linear
         = HdCyclesEnvValue<bool>("HD_CYCLES_DISPLAY_BUFFER_LINEAR", true);
+    display_buffer_float
+        = HdCyclesEnvValue<bool>("HD_CYCLES_DISPLAY_BUFFER_FLOAT", false);
 
     max_samples = HdCyclesEnvValue<int>("HD_CYCLES_MAX_SAMPLES", 512);
 
+    adaptive_sampling  = HdCyclesEnvValue<bool>("HD_CYCLES_ADAPTIVE_SAMPLING",
+                                                false);
+    adaptive_threshold = HdCyclesEnvValue<float>("HD_CYCLES_ADAPTIVE_THRESHOLD",
+                                                 0.01f);
+    time_limit = HdCyclesEnvValue<float>("HD_CYCLES_TIME_LIMIT", 0.0f);
+
+    enable_denoising = HdCyclesEnvValue<bool>("HD_CYCLES_ENABLE_DENOISING",
+                                              false);
+    denoising_start_sample
+        = HdCyclesEnvValue<int>("HD_CYCLES_DENOISING_START_SAMPLE", 0);
+
     num_threads      = HdCyclesEnvValue<int>("HD_CYCLES_NUM_THREADS", 0);
     pixel_size       = HdCyclesEnvValue<int>("HD_CYCLES_PIXEL_SIZE", 1);
     tile_size_x      = HdCyclesEnvValue<int>("HD_CYCLES_TILE_SIZE_X", 64);
     tile_size_y      = HdCyclesEnvValue<int>("HD_CYCLES_TILE_SIZE_Y", 64);
     start_resolution = HdCyclesEnvValue<int>("HD_CYCLES_START_RESOLUTION", 8);
+    upscale_bilinear = HdCyclesEnvValue<bool>("HD_CYCLES_UPSCALE_BILINEAR",
+                                              false);
+    target_frame_time
+        = HdCyclesEnvValue<float>("HD_CYCLES_TARGET_FRAME_TIME", 0.0f);
+    resize_delay = HdCyclesEnvValue<int>("HD_CYCLES_RESIZE_DELAY", 100);
     shutter_motion_position
         = HdCyclesEnvValue<int>("HD_CYCLES_SHUTTER_MOTION_POSITION", 1);
 
@@ -157,6 +184,14 @@ HdCyclesConfig::HdCyclesConfig()
     default_point_resolution
         = HdCyclesEnvValue<int>("HD_CYCLES_DEFAULT_POINT_RESOLUTION", 16);
 
+    interrupt_window  = HdCyclesEnvValue<int>("HD_CYCLES_INTERRUPT_WINDOW", 30);
+    interrupt_latency = HdCyclesEnvValue<int>("HD_CYCLES_INTERRUPT_LATENCY",
+                                              100);
+
+    reuse_session = HdCyclesEnvValue<bool>("HD_CYCLES_REUSE_SESSION", true);
+    sequence_mode = HdCyclesEnvValue<bool>("HD_CYCLES_SEQUENCE_MODE", false);
+    overlap_sync  = HdCyclesEnvValue<bool>("HD_CYCLES_OVERLAP_SYNC", false);
+
 
     // -- Curve Settings
 
@@ -180,7 +215,8 @@ HdCyclesConfig::HdCyclesConfig()
     subsurface_samples   = HdCyclesEnvValue<int>("HD_CYCLES_SUBSURFACE_SAMPLES",
                                                1);
     volume_samples       = HdCyclesEnvValue<int>("HD_CYCLES_VOLUME_SAMPLES", 1);
-    adaptive_min_samples = HdCyclesEnvValue<int>("HD_CYCLES_VOLUME_SAMPLES", 1);
+    adaptive_min_samples
+        = HdCyclesEnvValue<int>("HD_CYCLES_ADAPTIVE_MIN_SAMPLES", 0);
 }
 
 const HdCyclesConfig&
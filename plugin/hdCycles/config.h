@@ -123,6 +123,19 @@ public:
      */
     bool enable_progress;
 
+    /**
+     * @brief If enabled, HdCycles writes the timings of the Hydra to Cycles
+     * conversion to a Chrome trace file
+     *
+     */
+    bool enable_trace;
+
+    /**
+     * @brief Path of the Chrome trace file
+     *
+     */
+    std::string trace_file;
+
     /**
      * @brief Set custom up axis (Z or Y currently supported)
      *
@@ -208,6 +221,42 @@ public:
      */
     HdCyclesEnvValue<int> default_point_resolution;
 
+    /**
+     * @brief Quiet period in milliseconds after the last edit before the
+     * render is reset. Edits inside the window are merged into one reset.
+     * 
+     */
+    HdCyclesEnvValue<int> interrupt_window;
+
+    /**
+     * @brief Target edit to first pixel latency in milliseconds. Under
+     * continuous edits the render is still reset at least this often.
+     * 
+     */
+    HdCyclesEnvValue<int> interrupt_latency;
+
+    /**
+     * @brief Keep the Cycles session and device of a destroyed render
+     * delegate for the next one, skipping device creation and kernel loads
+     * 
+     */
+    HdCyclesEnvValue<bool> reuse_session;
+
+    /**
+     * @brief Keep converted prims between frames of a sequence and only
+     * update prims whose points, topology, transforms or material networks
+     * content hash changed
+     * 
+     */
+    HdCyclesEnvValue<bool> sequence_mode;
+
+    /**
+     * @brief Keep sampling the current frame while new data is published,
+     * and defer publishing while Cycles is busy updating the device
+     * 
+     */
+    HdCyclesEnvValue<bool> overlap_sync;
+
     /* ======= Cycles Settings ======= */
 
     /**
@@ -241,12 +290,56 @@ public:
      */
     HdCyclesEnvValue<bool> display_buffer_linear;
 
+    /**
+     * @brief Progressive color is read as float from the render buffers,
+     * with only the low resolution start passes taken from the display buffer
+     * Costs a full frame pass read at the display update rate, which a
+     * float color AOV takes without a copy.
+     *
+     */
+    HdCyclesEnvValue<bool> display_buffer_float;
+
     /**
      * @brief Number of samples to render
      *
      */
     HdCyclesEnvValue<int> max_samples;
 
+    /**
+     * @brief Stop sampling pixels once their noise is below the adaptive
+     * threshold
+     *
+     */
+    HdCyclesEnvValue<bool> adaptive_sampling;
+
+    /**
+     * @brief Noise threshold of adaptive sampling, 0 picks it from the
+     * number of samples
+     *
+     */
+    HdCyclesEnvValue<float> adaptive_threshold;
+
+    /**
+     * @brief Wall clock seconds after which a render is considered done,
+     * counted from the reset. 0 disables the limit
+     *
+     */
+    HdCyclesEnvValue<float> time_limit;
+
+    /**
+     * @brief Denoise the render on the CPU with Open Image Denoise, guided
+     * by the albedo and normal denoising features. Ignored with tiled
+     * rendering
+     *
+     */
+    HdCyclesEnvValue<bool> enable_denoising;
+
+    /**
+     * @brief Sample from which progressive renders are denoised
+     *
+     */
+    HdCyclesEnvValue<int> denoising_start_sample;
+
     /**
      * @brief Number of threads to use for cycles render
      *
@@ -277,6 +370,28 @@ public:
      */
     HdCyclesEnvValue<int> start_resolution;
 
+    /**
+     * @brief Milliseconds the first progressive pass should take. The start
+     * resolution of new sessions is then picked from the pass times measured
+     * so far, 0 keeps start_resolution
+     *
+     */
+    HdCyclesEnvValue<float> target_frame_time;
+
+    /**
+     * @brief Milliseconds the viewport size has to stay the same before the
+     * render is reset to it
+     *
+     */
+    HdCyclesEnvValue<int> resize_delay;
+
+    /**
+     * @brief Upscale low resolution progressive passes with bilinear
+     * filtering instead of nearest point sampling
+     *
+     */
+    HdCyclesEnvValue<bool> upscale_bilinear;
+
     /**
      * @brief Exposure of cycles film
      *
@@ -351,7 +466,8 @@ public:
     HdCyclesEnvValue<int> volume_samples;
 
     /**
-     * @brief Number of adaptive min samples
+     * @brief Number of adaptive min samples, 0 picks it from the number of
+     * samples
      *
      */
     HdCyclesEnvValue<int> adaptive_min_samples;
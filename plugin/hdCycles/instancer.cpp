@@ -19,6 +19,8 @@
 
 #include "instancer.h"
 
+#include "trace.h"
+
 #include <pxr/base/gf/matrix4f.h>
 #include <pxr/base/gf/quatd.h>
 #include <pxr/base/gf/quath.h>
@@ -41,7 +43,7 @@ TF_DEFINE_PRIVATE_TOKENS(_tokens,
 void
 HdCyclesInstancer::Sync()
 {
-    HD_TRACE_FUNCTION();
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesInstancer::Sync", GetId());
     HF_MALLOC_TAG_FUNCTION();
 
     const SdfPath& instancerId = GetId();
@@ -20,6 +20,7 @@
 #include "light.h"
 
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/object.h>
@@ -57,18 +58,15 @@ HdCyclesLight::HdCyclesLight(SdfPath const& id, TfToken const& lightType,
 
 HdCyclesLight::~HdCyclesLight()
 {
-    if (m_hdLightType == HdPrimTypeTokens->domeLight) {
-        m_renderDelegate->GetCyclesRenderParam()->SetBackgroundShader(nullptr);
+    // The default background is bound again once the light is removed
+    if (m_hdLightType == HdPrimTypeTokens->domeLight)
         m_renderDelegate->GetCyclesRenderParam()->Interrupt();
-    }
 
     if (m_cyclesLight) {
         if (m_cyclesLight->shader) {
             m_renderDelegate->GetCyclesRenderParam()->RemoveShader(m_cyclesLight->shader);
-            delete m_cyclesLight->shader;
         }
         m_renderDelegate->GetCyclesRenderParam()->RemoveLight(m_cyclesLight);
-        delete m_cyclesLight;
     }
 }
 
@@ -92,8 +90,8 @@ HdCyclesLight::_CreateCyclesLight(SdfPath const& id,
 
     if (m_hdLightType == HdPrimTypeTokens->domeLight) {
         m_cyclesLight->type = ccl::LIGHT_BACKGROUND;
+        // Bound as the world when the light is added to the scene
         shader->set_graph(_GetDefaultShaderGraph(true));
-        renderParam->SetBackgroundShader(shader);
     } else {
         if (m_hdLightType == HdPrimTypeTokens->diskLight) {
             m_cyclesLight->type  = ccl::LIGHT_AREA;
@@ -200,12 +198,25 @@ void
 HdCyclesLight::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                     HdDirtyBits* dirtyBits)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesLight::Sync", GetId());
+
     SdfPath id = GetId();
 
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
 
     ccl::Scene* scene = param->GetCyclesScene();
 
+    // Nothing else is read from the scene delegate
+    if (!(*dirtyBits
+          & (HdLight::DirtyParams | HdLight::DirtyTransform
+             | HdChangeTracker::DirtyVisibility))) {
+        *dirtyBits = HdChangeTracker::Clean;
+        return;
+    }
+
+    // Lights edit their light and shader in place
+    std::unique_lock<ccl::thread_mutex> sceneLock = param->LockScene();
+
     bool light_updated = false;
 
     if (*dirtyBits & HdLight::DirtyParams) {
@@ -634,6 +645,7 @@ HdCyclesLight::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         m_cyclesLight->shader->tag_update(scene);
         m_cyclesLight->tag_update(scene);
 
+        param->MarkChanged(HdCyclesRenderParam::LightChanged);
         param->Interrupt();
     }
 
@@ -22,6 +22,7 @@
 #include "config.h"
 #include "renderDelegate.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/nodes.h>
@@ -108,6 +109,16 @@ std::map<TfToken, ccl::VolumeSampling> VOLUME_SAMPLING_CONVERSION = {
       ccl::VOLUME_SAMPLING_MULTIPLE_IMPORTANCE },
 };
 
+// Materials sync in parallel, so the conversion maps above must only be
+// read. Missing keys resolve to the value initialized enum like operator[].
+template<typename T>
+T
+_ConversionLookup(const std::map<TfToken, T>& a_map, const TfToken& a_key)
+{
+    auto it = a_map.find(a_key);
+    return (it != a_map.end()) ? it->second : T();
+}
+
 #endif
 
 bool
@@ -140,15 +151,31 @@ HdCyclesMaterial::HdCyclesMaterial(SdfPath const& id,
     m_shaderGraph   = new ccl::ShaderGraph();
     m_shader->graph = m_shaderGraph;
 
+    m_stagedSettings.displacement_method    = m_shader->displacement_method;
+    m_stagedSettings.pass_id                = m_shader->pass_id;
+    m_stagedSettings.use_mis                = m_shader->use_mis;
+    m_stagedSettings.use_transparent_shadow = m_shader->use_transparent_shadow;
+    m_stagedSettings.heterogeneous_volume   = m_shader->heterogeneous_volume;
+    m_stagedSettings.volume_step_rate       = m_shader->volume_step_rate;
+    m_stagedSettings.volume_interpolation_method
+        = m_shader->volume_interpolation_method;
+    m_stagedSettings.volume_sampling_method = m_shader->volume_sampling_method;
+
     if (m_renderDelegate)
         m_renderDelegate->GetCyclesRenderParam()->AddShader(m_shader);
 }
 
 HdCyclesMaterial::~HdCyclesMaterial()
 {
+    if (m_renderDelegate)
+        m_renderDelegate->GetCyclesRenderParam()->UnstagePrim(this);
+
+    if (m_shaderGraph && m_shader && m_shaderGraph != m_shader->graph) {
+        delete m_shaderGraph;
+    }
+
     if (m_shader) {
         m_renderDelegate->GetCyclesRenderParam()->RemoveShader(m_shader);
-        delete m_shader;
     }
 }
 
@@ -670,31 +697,78 @@ GetMaterialNetwork(TfToken const& terminal, HdSceneDelegate* delegate,
     return true;
 }
 
+// Content hash of a material network map, parameter values included
+static size_t
+HashMaterialNetworkMap(HdMaterialNetworkMap const& networkMap)
+{
+    size_t hash = networkMap.map.size();
+    for (auto const& terminal : networkMap.map) {
+        HdCyclesHashCombine(hash, terminal.first.Hash());
+
+        for (HdMaterialNode const& node : terminal.second.nodes) {
+            HdCyclesHashCombine(hash, node.path.GetHash());
+            HdCyclesHashCombine(hash, node.identifier.Hash());
+            for (auto const& param : node.parameters) {
+                HdCyclesHashCombine(hash, param.first.Hash());
+                HdCyclesHashCombine(hash, param.second.GetHash());
+            }
+        }
+
+        for (HdMaterialRelationship const& rel :
+             terminal.second.relationships) {
+            HdCyclesHashCombine(hash, rel.inputId.GetHash());
+            HdCyclesHashCombine(hash, rel.inputName.Hash());
+            HdCyclesHashCombine(hash, rel.outputId.GetHash());
+            HdCyclesHashCombine(hash, rel.outputName.Hash());
+        }
+    }
+    return hash;
+}
+
 void
 HdCyclesMaterial::Sync(HdSceneDelegate* sceneDelegate,
                        HdRenderParam* renderParam, HdDirtyBits* dirtyBits)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMaterial::Sync", GetId());
+
     auto cyclesRenderParam     = static_cast<HdCyclesRenderParam*>(renderParam);
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
 
     const SdfPath& id = GetId();
 
-    param->GetCyclesScene()->mutex.lock();
+    // The graph and shader settings are staged without holding the scene
+    // mutex, and published into the scene by CommitStaged.
     bool material_updated = false;
 
     HdDirtyBits bits = *dirtyBits;
 
+    // In sequence mode networks with the same content as the last converted
+    // one are not converted again
+    const bool sequenceMode = param->IsSequenceMode();
 
     if (*dirtyBits & HdMaterial::DirtyResource) {
         VtValue vtMat = sceneDelegate->GetMaterialResource(id);
 
-        if (vtMat.IsHolding<HdMaterialNetworkMap>()) {
+        bool networkChanged = vtMat.IsHolding<HdMaterialNetworkMap>();
+        if (networkChanged && sequenceMode) {
+            networkChanged = HdCyclesUpdateHash(
+                m_networkHash, HashMaterialNetworkMap(
+                                   vtMat.UncheckedGet<HdMaterialNetworkMap>()));
+        }
+
+        if (networkChanged) {
             if (m_shaderGraph) {
+                // A previous graph that was never committed can be dropped
+                if (m_shaderGraph != m_shader->graph) {
+                    delete m_shaderGraph;
+                }
                 m_shaderGraph = new ccl::ShaderGraph();
             }
 
             auto& networkMap = vtMat.UncheckedGet<HdMaterialNetworkMap>();
 
+            HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMaterial::ConvertNetwork", id);
+
             HdMaterialNetwork const* surface      = nullptr;
             HdMaterialNetwork const* displacement = nullptr;
             HdMaterialNetwork const* volume       = nullptr;
@@ -740,79 +814,116 @@ HdCyclesMaterial::Sync(HdSceneDelegate* sceneDelegate,
             usdCyclesTokens->cyclesMaterialDisplacement_method,
             usdCyclesTokens->displacement_bump);
 
-        if (m_shader->displacement_method
-            != DISPLACEMENT_CONVERSION[displacementMethod]) {
-            m_shader->displacement_method
-                = DISPLACEMENT_CONVERSION[displacementMethod];
-        }
+        m_stagedSettings.displacement_method
+            = _ConversionLookup(DISPLACEMENT_CONVERSION, displacementMethod);
 
-        m_shader->pass_id
+        m_stagedSettings.pass_id
             = _HdCyclesGetParam<int>(sceneDelegate, id,
                                      usdCyclesTokens->cyclesMaterialPass_id,
-                                     m_shader->pass_id);
+                                     m_stagedSettings.pass_id);
 
-        m_shader->use_mis
+        m_stagedSettings.use_mis
             = _HdCyclesGetParam<bool>(sceneDelegate, id,
                                       usdCyclesTokens->cyclesMaterialUse_mis,
-                                      m_shader->use_mis);
+                                      m_stagedSettings.use_mis);
 
-        m_shader->use_transparent_shadow = _HdCyclesGetParam<bool>(
+        m_stagedSettings.use_transparent_shadow = _HdCyclesGetParam<bool>(
             sceneDelegate, id,
             usdCyclesTokens->cyclesMaterialUse_transparent_shadow,
-            m_shader->use_transparent_shadow);
+            m_stagedSettings.use_transparent_shadow);
 
-        m_shader->heterogeneous_volume = _HdCyclesGetParam<bool>(
+        m_stagedSettings.heterogeneous_volume = _HdCyclesGetParam<bool>(
             sceneDelegate, id,
             usdCyclesTokens->cyclesMaterialHeterogeneous_volume,
-            m_shader->heterogeneous_volume);
+            m_stagedSettings.heterogeneous_volume);
 
-        m_shader->volume_step_rate = _HdCyclesGetParam<float>(
+        m_stagedSettings.volume_step_rate = _HdCyclesGetParam<float>(
             sceneDelegate, id, usdCyclesTokens->cyclesMaterialVolume_step_rate,
-            m_shader->volume_step_rate);
+            m_stagedSettings.volume_step_rate);
 
         TfToken volume_interpolation = _HdCyclesGetParam<TfToken>(
             sceneDelegate, id,
             usdCyclesTokens->cyclesMaterialVolume_interpolation_method,
             usdCyclesTokens->volume_interpolation_linear);
 
-        if (m_shader->volume_interpolation_method
-            != VOLUME_INTERPOLATION_CONVERSION[volume_interpolation]) {
-            m_shader->volume_interpolation_method
-                = VOLUME_INTERPOLATION_CONVERSION[volume_interpolation];
-        }
+        m_stagedSettings.volume_interpolation_method = _ConversionLookup(
+            VOLUME_INTERPOLATION_CONVERSION, volume_interpolation);
 
         TfToken volume_sampling = _HdCyclesGetParam<TfToken>(
             sceneDelegate, id,
             usdCyclesTokens->cyclesMaterialVolume_sampling_method,
             usdCyclesTokens->volume_sampling_multiple_importance);
 
-        if (m_shader->volume_sampling_method
-            != VOLUME_SAMPLING_CONVERSION[volume_sampling]) {
-            m_shader->volume_sampling_method
-                = VOLUME_SAMPLING_CONVERSION[volume_sampling];
+        m_stagedSettings.volume_sampling_method
+            = _ConversionLookup(VOLUME_SAMPLING_CONVERSION, volume_sampling);
+
+        const std::hash<float> floatHash;
+
+        size_t settingsHash = std::hash<int>()(
+            m_stagedSettings.displacement_method);
+        HdCyclesHashCombine(settingsHash, m_stagedSettings.pass_id);
+        HdCyclesHashCombine(settingsHash, m_stagedSettings.use_mis);
+        HdCyclesHashCombine(settingsHash,
+                            m_stagedSettings.use_transparent_shadow);
+        HdCyclesHashCombine(settingsHash,
+                            m_stagedSettings.heterogeneous_volume);
+        HdCyclesHashCombine(settingsHash,
+                            floatHash(m_stagedSettings.volume_step_rate));
+        HdCyclesHashCombine(settingsHash,
+                            m_stagedSettings.volume_interpolation_method);
+        HdCyclesHashCombine(settingsHash,
+                            m_stagedSettings.volume_sampling_method);
+
+        if (!sequenceMode
+            || HdCyclesUpdateHash(m_settingsHash, settingsHash)) {
+            material_updated = true;
         }
-        material_updated = true;
 
 #endif
     }
 
     if (material_updated) {
-        if (m_shader->graph != m_shaderGraph) {
-            m_shader->set_graph(m_shaderGraph);
-        }
-
-        m_shader->tag_update(param->GetCyclesScene());
-        m_shader->tag_used(param->GetCyclesScene());
+        m_shaderUpdated = true;
+        param->StagePrim(this);
         param->Interrupt();
 
         _DumpGraph(m_shaderGraph, m_shader->name.c_str());
     }
 
-    param->GetCyclesScene()->mutex.unlock();
-
     *dirtyBits = Clean;
 }
 
+void
+HdCyclesMaterial::CommitStaged(ccl::Scene* scene)
+{
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMaterial::CommitStaged", GetId());
+
+    if (!m_shaderUpdated)
+        return;
+
+    m_shader->displacement_method    = m_stagedSettings.displacement_method;
+    m_shader->pass_id                = m_stagedSettings.pass_id;
+    m_shader->use_mis                = m_stagedSettings.use_mis;
+    m_shader->use_transparent_shadow = m_stagedSettings.use_transparent_shadow;
+    m_shader->heterogeneous_volume   = m_stagedSettings.heterogeneous_volume;
+    m_shader->volume_step_rate       = m_stagedSettings.volume_step_rate;
+    m_shader->volume_interpolation_method
+        = m_stagedSettings.volume_interpolation_method;
+    m_shader->volume_sampling_method = m_stagedSettings.volume_sampling_method;
+
+    if (m_shader->graph != m_shaderGraph) {
+        m_shader->set_graph(m_shaderGraph);
+    }
+
+    m_shader->tag_update(scene);
+    m_shader->tag_used(scene);
+
+    m_renderDelegate->GetCyclesRenderParam()->MarkChanged(
+        HdCyclesRenderParam::ShaderChanged);
+
+    m_shaderUpdated = false;
+}
+
 ccl::Shader*
 HdCyclesMaterial::GetCyclesShader() const
 {
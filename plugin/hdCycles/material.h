@@ -22,6 +22,10 @@
 
 #include "api.h"
 
+#include "renderParam.h"
+
+#include <render/shader.h>
+
 #include <pxr/imaging/hd/material.h>
 #include <pxr/pxr.h>
 
@@ -57,7 +61,7 @@ class HdCyclesRenderDelegate;
  * @brief HdCycles Material Sprim mapped to Cycles Material
  * 
  */
-class HdCyclesMaterial final : public HdMaterial {
+class HdCyclesMaterial final : public HdMaterial, public HdCyclesStagedPrim {
 public:
     /**
      * @brief Construct a new HdCycles Material
@@ -97,6 +101,14 @@ public:
     HDCYCLES_API
     HdDirtyBits GetInitialDirtyBitsMask() const override;
 
+    /**
+     * @brief Publish the staged shader graph and settings into the Cycles
+     * scene. Called with the scene mutex held.
+     * 
+     * @param scene Cycles scene
+     */
+    void CommitStaged(ccl::Scene* scene) override;
+
     /**
      * @brief Causes the shader to be reloaded
      * 
@@ -127,6 +139,25 @@ protected:
     ccl::Shader* m_shader;
     ccl::ShaderGraph* m_shaderGraph;
 
+    // Shader settings staged in Sync, applied in CommitStaged
+    struct ShaderSettings {
+        ccl::DisplacementMethod displacement_method;
+        int pass_id;
+        bool use_mis;
+        bool use_transparent_shadow;
+        bool heterogeneous_volume;
+        float volume_step_rate;
+        ccl::VolumeInterpolation volume_interpolation_method;
+        ccl::VolumeSampling volume_sampling_method;
+    };
+    ShaderSettings m_stagedSettings;
+    bool m_shaderUpdated = false;
+
+    // Content hashes of the last converted network and settings, used in
+    // sequence mode
+    size_t m_networkHash  = 0;
+    size_t m_settingsHash = 0;
+
     HdCyclesRenderDelegate* m_renderDelegate;
 };
 
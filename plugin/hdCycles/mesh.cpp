@@ -24,10 +24,12 @@
 #include "material.h"
 #include "renderDelegate.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include "Mikktspace/mikktspace.h"
 
+#include <algorithm>
 #include <vector>
 
 #include <render/mesh.h>
@@ -113,30 +115,41 @@ HdCyclesMesh::HdCyclesMesh(SdfPath const& id, SdfPath const& instancerId,
 
     m_cyclesObject->geometry = m_cyclesMesh;
 
-    m_renderDelegate->GetCyclesRenderParam()->AddGeometry(m_cyclesMesh);
-    m_renderDelegate->GetCyclesRenderParam()->AddObject(m_cyclesObject);
+    // Mesh and object are added to the scene in the first CommitStaged
 }
 
 HdCyclesMesh::~HdCyclesMesh()
 {
+    HdCyclesRenderParam* param = m_renderDelegate->GetCyclesRenderParam();
+
+    param->UnstagePrim(this);
+
+    if (m_stagedMesh) {
+        delete m_stagedMesh;
+    }
+
+    for (auto instance : m_stagedInstances) {
+        delete instance;
+    }
+
+    // The render param takes ownership of anything it removes
     if (m_cyclesMesh) {
-        m_renderDelegate->GetCyclesRenderParam()->RemoveMesh(m_cyclesMesh);
-        delete m_cyclesMesh;
+        if (m_isInScene)
+            param->RemoveMesh(m_cyclesMesh);
+        else
+            delete m_cyclesMesh;
     }
 
     if (m_cyclesObject) {
-        m_renderDelegate->GetCyclesRenderParam()->RemoveObject(m_cyclesObject);
-        delete m_cyclesObject;
+        if (m_isInScene)
+            param->RemoveObject(m_cyclesObject);
+        else
+            delete m_cyclesObject;
     }
 
-    if (m_cyclesInstances.size() > 0) {
-        for (auto instance : m_cyclesInstances) {
-            if (instance) {
-                m_renderDelegate->GetCyclesRenderParam()->RemoveObject(
-                    instance);
-                delete instance;
-            }
-        }
+    for (auto instance : m_cyclesInstances) {
+        if (instance)
+            param->RemoveObject(instance);
     }
 }
 
@@ -209,36 +222,33 @@ HdCyclesMesh::_ComputeTangents(bool needsign)
 {
     // This is likely deprecated now
     const ccl::AttributeSet& attributes = (m_useSubdivision && m_subdivEnabled)
-                                              ? m_cyclesMesh->subd_attributes
-                                              : m_cyclesMesh->attributes;
+                                              ? m_stagedMesh->subd_attributes
+                                              : m_stagedMesh->attributes;
 
     ccl::Attribute* attr = attributes.find(ccl::ATTR_STD_UV);
     if (attr) {
+        HD_CYCLES_TRACE_PRIM_SCOPE("mikk_compute_tangents", GetId());
         mikk_compute_tangents(attr->standard_name(ccl::ATTR_STD_UV),
-                              m_cyclesMesh, needsign, true);
+                              m_stagedMesh, needsign, true);
     }
 }
 
 void
-HdCyclesMesh::_AddUVSet(TfToken name, VtVec2fArray& uvs, ccl::Scene* scene,
+HdCyclesMesh::_AddUVSet(TfToken name, VtVec2fArray& uvs,
                         HdInterpolation interpolation)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMesh::_AddUVSet", GetId());
+
     ccl::AttributeSet* attributes = (m_useSubdivision && m_subdivEnabled)
-                                        ? &m_cyclesMesh->subd_attributes
-                                        : &m_cyclesMesh->attributes;
+                                        ? &m_stagedMesh->subd_attributes
+                                        : &m_stagedMesh->attributes;
     bool subdivide_uvs = false;
 
     ccl::ustring uv_name      = ccl::ustring(name.GetString());
-    ccl::ustring tangent_name = ccl::ustring(name.GetString() + ".tangent");
-
-    bool need_uv = m_cyclesMesh->need_attribute(scene, uv_name)
-                   || m_cyclesMesh->need_attribute(scene, ccl::ATTR_STD_UV);
-    bool need_tangent
-        = m_cyclesMesh->need_attribute(scene, tangent_name)
-          || m_cyclesMesh->need_attribute(scene, ccl::ATTR_STD_UV_TANGENT);
 
-    // Forced true for now... Should be based on shader compilation needs
-    need_tangent = true;
+    // Forced true for now... Should be based on shader compilation needs,
+    // which can't be read from the live shaders during Sync
+    bool need_tangent = true;
 
     ccl::Attribute* attr = attributes->add(ccl::ATTR_STD_UV, uv_name);
     ccl::float2* fdata   = attr->data_float2();
@@ -279,17 +289,11 @@ HdCyclesMesh::_AddUVSet(TfToken name, VtVec2fArray& uvs, ccl::Scene* scene,
     }
 
     if (need_tangent) {
-        ccl::ustring sign_name = ccl::ustring(name.GetString()
-                                              + ".tangent_sign");
-        bool need_sign
-            = m_cyclesMesh->need_attribute(scene, sign_name)
-              || m_cyclesMesh->need_attribute(scene,
-                                              ccl::ATTR_STD_UV_TANGENT_SIGN);
-
-
         // Forced for now
-        need_sign = true;
-        mikk_compute_tangents(name.GetString().c_str(), m_cyclesMesh, need_sign,
+        bool need_sign = true;
+
+        HD_CYCLES_TRACE_PRIM_SCOPE("mikk_compute_tangents", GetId());
+        mikk_compute_tangents(name.GetString().c_str(), m_stagedMesh, need_sign,
                               true);
     }
 }
@@ -299,11 +303,11 @@ HdCyclesMesh::_AddVelocities(VtVec3fArray& velocities,
                              HdInterpolation interpolation)
 {
     ccl::AttributeSet* attributes = (m_useSubdivision && m_subdivEnabled)
-                                        ? &m_cyclesMesh->subd_attributes
-                                        : &m_cyclesMesh->attributes;
+                                        ? &m_stagedMesh->subd_attributes
+                                        : &m_stagedMesh->attributes;
 
-    m_cyclesMesh->use_motion_blur = true;
-    m_cyclesMesh->motion_steps    = 3;
+    m_stagedMesh->use_motion_blur = true;
+    m_stagedMesh->motion_steps    = 3;
 
     ccl::Attribute* attr_mP = attributes->find(
         ccl::ATTR_STD_MOTION_VERTEX_POSITION);
@@ -345,7 +349,7 @@ HdCyclesMesh::_AddVelocities(VtVec3fArray& velocities,
 
     ccl::float3* mP = attr_mP->data_float3();
 
-    for (size_t i = 0; i < m_cyclesMesh->motion_steps; ++i) {
+    for (size_t i = 0; i < m_stagedMesh->motion_steps; ++i) {
         //VtVec3fArray pp;
         //pp = m_pointSamples.values.data()[i].Get<VtVec3fArray>();
 
@@ -357,22 +361,19 @@ HdCyclesMesh::_AddVelocities(VtVec3fArray& velocities,
 }
 
 void
-HdCyclesMesh::_AddColors(TfToken name, VtVec3fArray& colors, ccl::Scene* scene,
+HdCyclesMesh::_AddColors(TfToken name, VtVec3fArray& colors,
                          HdInterpolation interpolation)
 {
     if (colors.size() <= 0)
         return;
 
     ccl::AttributeSet* attributes = (m_useSubdivision && m_subdivEnabled)
-                                        ? &m_cyclesMesh->subd_attributes
-                                        : &m_cyclesMesh->attributes;
+                                        ? &m_stagedMesh->subd_attributes
+                                        : &m_stagedMesh->attributes;
 
     ccl::AttributeStandard vcol_std = ccl::ATTR_STD_VERTEX_COLOR;
     ccl::ustring vcol_name          = ccl::ustring(name.GetString());
 
-    const bool need_vcol = m_cyclesMesh->need_attribute(scene, vcol_name)
-                           || m_cyclesMesh->need_attribute(scene, vcol_std);
-
     ccl::Attribute* vcol_attr = NULL;
     vcol_attr                 = attributes->add(vcol_std, vcol_name);
 
@@ -435,7 +436,7 @@ HdCyclesMesh::_AddColors(TfToken name, VtVec3fArray& colors, ccl::Scene* scene,
 void
 HdCyclesMesh::_AddNormals(VtVec3fArray& normals, HdInterpolation interpolation)
 {
-    ccl::AttributeSet& attributes = m_cyclesMesh->attributes;
+    ccl::AttributeSet& attributes = m_stagedMesh->attributes;
 
     if (interpolation == HdInterpolationUniform) {
         ccl::Attribute* attr_fN = attributes.add(ccl::ATTR_STD_FACE_NORMAL);
@@ -455,9 +456,9 @@ HdCyclesMesh::_AddNormals(VtVec3fArray& normals, HdInterpolation interpolation)
         ccl::Attribute* attr = attributes.add(ccl::ATTR_STD_VERTEX_NORMAL);
         ccl::float3* cdata   = attr->data_float3();
 
-        memset(cdata, 0, m_cyclesMesh->verts.size() * sizeof(ccl::float3));
+        memset(cdata, 0, m_stagedMesh->verts.size() * sizeof(ccl::float3));
 
-        for (size_t i = 0; i < m_cyclesMesh->verts.size(); i++) {
+        for (size_t i = 0; i < m_stagedMesh->verts.size(); i++) {
             ccl::float3 n = vec3f_to_float3(normals[i]);
             if (m_orientation == HdTokens->leftHanded)
                 n = -n;
@@ -470,12 +471,12 @@ HdCyclesMesh::_AddNormals(VtVec3fArray& normals, HdInterpolation interpolation)
 
         // TODO: For now, this method produces very wrong results. Some other solution will be needed
 
-        m_cyclesMesh->add_face_normals();
-        m_cyclesMesh->add_vertex_normals();
+        m_stagedMesh->add_face_normals();
+        m_stagedMesh->add_vertex_normals();
 
         return;
 
-        //memset(cdata, 0, m_cyclesMesh->verts.size() * sizeof(ccl::float3));
+        //memset(cdata, 0, m_stagedMesh->verts.size() * sizeof(ccl::float3));
 
         // Although looping through all faces, normals are averaged per
         // vertex. This seems to be a limitation of cycles. Not allowing
@@ -486,11 +487,11 @@ HdCyclesMesh::_AddNormals(VtVec3fArray& normals, HdInterpolation interpolation)
         /*for (size_t i = 0; i < m_numMeshFaces; i++) {
             for (size_t j = 0; j < 3; j++) {
                 ccl::float3 n = vec3f_to_float3(normals[(i * 3) + j]);
-                cdata[m_cyclesMesh->get_triangle(i).v[j]] += n;
+                cdata[m_stagedMesh->get_triangle(i).v[j]] += n;
             }
         }
 
-        for (size_t i = 0; i < m_cyclesMesh->verts.size(); i++) {
+        for (size_t i = 0; i < m_stagedMesh->verts.size(); i++) {
             cdata[i] = ccl::normalize(cdata[i]);
         }*/
     }
@@ -504,11 +505,9 @@ HdCyclesMesh::_CreateCyclesMesh()
 
     if (m_useMotionBlur && m_useDeformMotionBlur) {
         mesh->use_motion_blur = true;
+        mesh->motion_steps    = m_motionSteps;
     }
 
-    m_numMeshVerts = 0;
-    m_numMeshFaces = 0;
-
     mesh->subdivision_type = ccl::Mesh::SUBDIVISION_NONE;
     return mesh;
 }
@@ -519,7 +518,7 @@ HdCyclesMesh::_CreateCyclesObject()
     ccl::Object* object = new ccl::Object();
 
     object->tfm     = ccl::transform_identity();
-    object->pass_id = -1;
+    object->pass_id = m_passId;
 
     object->visibility = ccl::PATH_RAY_ALL_VISIBILITY;
 
@@ -529,9 +528,9 @@ HdCyclesMesh::_CreateCyclesObject()
 void
 HdCyclesMesh::_PopulateVertices()
 {
-    m_cyclesMesh->verts.reserve(m_numMeshVerts);
+    m_stagedMesh->verts.reserve(m_numMeshVerts);
     for (int i = 0; i < m_points.size(); i++) {
-        m_cyclesMesh->verts.push_back_reserved(vec3f_to_float3(m_points[i]));
+        m_stagedMesh->verts.push_back_reserved(vec3f_to_float3(m_points[i]));
     }
 }
 
@@ -543,12 +542,12 @@ HdCyclesMesh::_PopulateMotion()
     }
 
     ccl::AttributeSet* attributes = (m_useSubdivision)
-                                        ? &m_cyclesMesh->subd_attributes
-                                        : &m_cyclesMesh->attributes;
+                                        ? &m_stagedMesh->subd_attributes
+                                        : &m_stagedMesh->attributes;
 
-    m_cyclesMesh->use_motion_blur = true;
+    m_stagedMesh->use_motion_blur = true;
 
-    m_cyclesMesh->motion_steps = m_pointSamples.count + 1;
+    m_stagedMesh->motion_steps = m_pointSamples.count + 1;
 
     ccl::Attribute* attr_mP = attributes->find(
         ccl::ATTR_STD_MOTION_VERTEX_POSITION);
@@ -578,12 +577,14 @@ void
 HdCyclesMesh::_PopulateFaces(const std::vector<int>& a_faceMaterials,
                              bool a_subdivide)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMesh::_PopulateFaces", GetId());
+
     if (a_subdivide) {
-        m_cyclesMesh->subdivision_type = ccl::Mesh::SUBDIVISION_CATMULL_CLARK;
-        m_cyclesMesh->reserve_subd_faces(m_numMeshFaces, m_numNgons,
+        m_stagedMesh->subdivision_type = ccl::Mesh::SUBDIVISION_CATMULL_CLARK;
+        m_stagedMesh->reserve_subd_faces(m_numMeshFaces, m_numNgons,
                                          m_numCorners);
     } else {
-        m_cyclesMesh->reserve_mesh(m_numMeshVerts, m_numMeshFaces);
+        m_stagedMesh->reserve_mesh(m_numMeshVerts, m_numMeshFaces);
     }
 
     VtIntArray::const_iterator idxIt = m_faceVertexIndices.begin();
@@ -609,7 +610,7 @@ HdCyclesMesh::_PopulateFaces(const std::vector<int>& a_faceMaterials,
 
             idxIt += vCount;
 
-            m_cyclesMesh->add_subd_face(&vi[0], vCount, materialId, true);
+            m_stagedMesh->add_subd_face(&vi[0], vCount, materialId, true);
         }
     } else {
         for (int i = 0; i < m_faceVertexCounts.size(); i++) {
@@ -627,10 +628,10 @@ HdCyclesMesh::_PopulateFaces(const std::vector<int>& a_faceMaterials,
                 if (v0 < m_numMeshVerts && v1 < m_numMeshVerts
                     && v2 < m_numMeshVerts) {
                     if (m_orientation == HdTokens->rightHanded) {
-                        m_cyclesMesh->add_triangle(v0, v1, v2, materialId,
+                        m_stagedMesh->add_triangle(v0, v1, v2, materialId,
                                                    true);
                     } else {
-                        m_cyclesMesh->add_triangle(v0, v2, v1, materialId,
+                        m_stagedMesh->add_triangle(v0, v2, v1, materialId,
                                                    true);
                     }
                 }
@@ -645,9 +646,9 @@ HdCyclesMesh::_PopulateCreases()
 {
     size_t num_creases = m_creaseLengths.size();
 
-    m_cyclesMesh->subd_creases.resize(num_creases);
+    m_stagedMesh->subd_creases.resize(num_creases);
 
-    ccl::Mesh::SubdEdgeCrease* crease = m_cyclesMesh->subd_creases.data();
+    ccl::Mesh::SubdEdgeCrease* crease = m_stagedMesh->subd_creases.data();
     for (int i = 0; i < num_creases; i++) {
         crease->v[0]   = m_creaseIndices[(i * 2) + 0];
         crease->v[1]   = m_creaseIndices[(i * 2) + 1];
@@ -658,54 +659,66 @@ HdCyclesMesh::_PopulateCreases()
 }
 
 void
-HdCyclesMesh::_PopulateGenerated(ccl::Scene* scene)
+HdCyclesMesh::_PopulateGenerated()
 {
-    if (m_cyclesMesh->need_attribute(scene, ccl::ATTR_STD_GENERATED)) {
-        ccl::float3 loc, size;
-        HdCyclesMeshTextureSpace(m_cyclesMesh, loc, size);
-
-        ccl::AttributeSet* attributes = (m_useSubdivision)
-                                            ? &m_cyclesMesh->subd_attributes
-                                            : &m_cyclesMesh->attributes;
-        ccl::Attribute* attr = attributes->add(ccl::ATTR_STD_GENERATED);
-
-        ccl::float3* generated = attr->data_float3();
-        for (int i = 0; i < m_cyclesMesh->verts.size(); i++) {
-            generated[i] = m_cyclesMesh->verts[i] * size - loc;
-        }
+    // Always computed, CommitStaged drops them if no shader reads them
+    ccl::float3 loc, size;
+    HdCyclesMeshTextureSpace(m_stagedMesh, loc, size);
+
+    ccl::AttributeSet* attributes = (m_useSubdivision)
+                                        ? &m_stagedMesh->subd_attributes
+                                        : &m_stagedMesh->attributes;
+    ccl::Attribute* attr = attributes->add(ccl::ATTR_STD_GENERATED);
+
+    ccl::float3* generated = attr->data_float3();
+    for (int i = 0; i < m_stagedMesh->verts.size(); i++) {
+        generated[i] = m_stagedMesh->verts[i] * size - loc;
     }
 }
 
 void
-HdCyclesMesh::_FinishMesh(ccl::Scene* scene)
+HdCyclesMesh::_FinishMesh()
 {
     // Deprecated in favour of adding when uv's are added
     // This should no longer be necessary
     //_ComputeTangents(true);
 
     // This must be done first, because HdCyclesMeshTextureSpace requires computed min/max
-    m_cyclesMesh->compute_bounds();
+    m_stagedMesh->compute_bounds();
 
-    _PopulateGenerated(scene);
+    _PopulateGenerated();
 }
 
 void
 HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                    HdDirtyBits* dirtyBits, TfToken const& reprToken)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMesh::Sync", GetId());
+
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
     ccl::Scene* scene          = param->GetCyclesScene();
 
-    scene->mutex.lock();
+    // The scene mutex is not held during Sync. Everything is converted into
+    // staging data (m_stagedMesh, m_stagedInstances and the members below)
+    // and published into the scene by CommitStaged.
 
     const SdfPath& id = GetId();
 
+    // In sequence mode dirty data is compared against the content hash of
+    // the last conversion, prims that didn't actually change on a new frame
+    // are not converted again.
+    const bool sequenceMode = param->IsSequenceMode();
+
     // -------------------------------------
     // -- Pull scene data
 
     bool mesh_updated = false;
 
-    bool newMesh = false;
+    // newMesh converts the mesh data again, newTopology also replaces the
+    // mesh in the scene. Point and primvar edits keep the scene mesh and
+    // its BVH, CommitStaged only moves the new vertex and attribute data
+    bool newMesh     = false;
+    bool newTopology = false;
 
     bool pointsIsComputed = false;
 
@@ -718,18 +731,22 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
             continue;
 
         if (HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, desc.name)) {
-            mesh_updated    = true;
             auto valueStore = HdExtComputationUtils::GetComputedPrimvarValues(
                 { desc }, sceneDelegate);
             auto pointValueIt = valueStore.find(desc.name);
             if (pointValueIt != valueStore.end()) {
                 if (!pointValueIt->second.IsEmpty()) {
-                    m_points       = pointValueIt->second.Get<VtVec3fArray>();
-                    m_numMeshVerts = m_points.size();
-
-                    m_normalsValid   = false;
                     pointsIsComputed = true;
-                    newMesh          = true;
+                    if (!sequenceMode
+                        || HdCyclesUpdateHash(m_pointsHash,
+                                              pointValueIt->second.GetHash())) {
+                        m_points = pointValueIt->second.Get<VtVec3fArray>();
+                        m_numMeshVerts = m_points.size();
+
+                        m_normalsValid = false;
+                        mesh_updated   = true;
+                        newMesh        = true;
+                    }
                 }
             }
         }
@@ -738,27 +755,43 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
     if (!pointsIsComputed
         && HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, HdTokens->points)) {
-        mesh_updated        = true;
         VtValue pointsValue = sceneDelegate->Get(id, HdTokens->points);
         if (!pointsValue.IsEmpty()) {
-            m_points = pointsValue.Get<VtVec3fArray>();
-            if (m_points.size() > 0) {
-                m_numMeshVerts = m_points.size();
-
-                m_normalsValid = false;
-                newMesh        = true;
-            }
-
             // TODO: Should we check if time varying?
             // TODO: can we use this for m_points too?
             sceneDelegate->SamplePrimvar(id, HdTokens->points, &m_pointSamples);
+
+            size_t pointsHash = pointsValue.GetHash();
+            HdCyclesHashCombine(pointsHash,
+                                HdCyclesHashPrimvarSamples(m_pointSamples));
+
+            if (!sequenceMode || HdCyclesUpdateHash(m_pointsHash, pointsHash)) {
+                mesh_updated = true;
+                m_points     = pointsValue.Get<VtVec3fArray>();
+                if (m_points.size() > 0) {
+                    m_numMeshVerts = m_points.size();
+
+                    m_normalsValid = false;
+                    newMesh        = true;
+                }
+            }
         }
     }
 
     static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
 
+    bool topologyChanged = false;
     if (HdChangeTracker::IsTopologyDirty(*dirtyBits, id)) {
-        m_topology          = GetMeshTopology(sceneDelegate);
+        HdMeshTopology topology = GetMeshTopology(sceneDelegate);
+        if (!sequenceMode
+            || HdCyclesUpdateHash(m_topologyHash,
+                                  HdCyclesHashMeshTopology(topology))) {
+            m_topology      = topology;
+            topologyChanged = true;
+        }
+    }
+
+    if (topologyChanged) {
         m_faceVertexCounts  = m_topology.GetFaceVertexCounts();
         m_faceVertexIndices = m_topology.GetFaceVertexIndices();
         m_geomSubsets       = m_topology.GetGeomSubsets();
@@ -809,7 +842,8 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                                == PxOsdOpenSubdivTokens->catmullClark;
         }
 
-        newMesh = true;
+        newMesh     = true;
+        newTopology = true;
     }
 
     std::map<HdInterpolation, HdPrimvarDescriptorVector>
@@ -823,6 +857,36 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                                                    HdInterpolationConstant) },
         };
 
+    // Primvars converted with the mesh data. Like the points, in sequence
+    // mode they only convert the mesh again when their content changed.
+    bool primvarsDirty  = false;
+    size_t primvarsHash = 0;
+    for (auto& primvarDescsEntry : primvarDescsPerInterpolation) {
+        for (auto& pv : primvarDescsEntry.second) {
+            if (pv.name == HdTokens->points
+                || !HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, pv.name))
+                continue;
+
+            const VtValue value = GetPrimvar(sceneDelegate, pv.name);
+            if (pv.name != HdTokens->normals
+                && pv.name != HdTokens->velocities
+                && pv.role != HdPrimvarRoleTokens->color
+                && !value.IsHolding<VtArray<GfVec2f>>())
+                continue;
+
+            primvarsDirty = true;
+            HdCyclesHashCombine(primvarsHash, pv.name.Hash());
+            HdCyclesHashCombine(primvarsHash, value.GetHash());
+        }
+    }
+
+    if (primvarsDirty
+        && (!sequenceMode
+            || HdCyclesUpdateHash(m_primvarsHash, primvarsHash))) {
+        mesh_updated = true;
+        newMesh      = true;
+    }
+
     if (*dirtyBits & HdChangeTracker::DirtyDoubleSided) {
         mesh_updated  = true;
         m_doubleSided = sceneDelegate->GetDoubleSided(id);
@@ -840,22 +904,35 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
             isRefineLevelDirty = true;
             m_refineLevel      = m_displayStyle.refineLevel;
             newMesh            = true;
+            newTopology        = true;
         }
     }
 
     if (HdChangeTracker::IsSubdivTagsDirty(*dirtyBits, id)) {
         const PxOsdSubdivTags subdivTags = GetSubdivTags(sceneDelegate);
 
-        m_cornerIndices = subdivTags.GetCornerIndices();
-        m_cornerWeights = subdivTags.GetCornerWeights();
-        m_creaseIndices = subdivTags.GetCreaseIndices();
-        m_creaseLengths = subdivTags.GetCreaseLengths();
-        m_creaseWeights = subdivTags.GetCreaseWeights();
+        if (!sequenceMode
+            || HdCyclesUpdateHash(m_subdivTagsHash, subdivTags.ComputeHash())) {
+            m_cornerIndices = subdivTags.GetCornerIndices();
+            m_cornerWeights = subdivTags.GetCornerWeights();
+            m_creaseIndices = subdivTags.GetCreaseIndices();
+            m_creaseLengths = subdivTags.GetCreaseLengths();
+            m_creaseWeights = subdivTags.GetCreaseWeights();
 
-        newMesh = true;
+            newMesh     = true;
+            newTopology = true;
+        }
     }
 
 #ifdef USE_USD_CYCLES_SCHEMA
+    // Object flags before the primvars are read, only an actual change
+    // needs the objects updated
+    const bool wasShadowCatcher  = m_isShadowCatcher;
+    const bool usedHoldout       = m_useHoldout;
+    const bool prevVisibility[6] = { m_visCamera, m_visDiffuse,
+                                     m_visGlossy, m_visScatter,
+                                     m_visShadow, m_visTransmission };
+
     for (auto& primvarDescsEntry : primvarDescsPerInterpolation) {
         for (auto& pv : primvarDescsEntry.second) {
             // Mesh Specific
@@ -881,12 +958,11 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                 subdivisionType);
 
             if (subdivisionType == usdCyclesTokens->catmull_clark) {
-                m_cyclesMesh->subdivision_type
-                    = ccl::Mesh::SUBDIVISION_CATMULL_CLARK;
+                m_subdivisionType = ccl::Mesh::SUBDIVISION_CATMULL_CLARK;
             } else if (subdivisionType == usdCyclesTokens->linear) {
-                m_cyclesMesh->subdivision_type = ccl::Mesh::SUBDIVISION_LINEAR;
+                m_subdivisionType = ccl::Mesh::SUBDIVISION_LINEAR;
             } else {
-                m_cyclesMesh->subdivision_type = ccl::Mesh::SUBDIVISION_NONE;
+                m_subdivisionType = ccl::Mesh::SUBDIVISION_NONE;
             }
 
             m_dicingRate = _HdCyclesGetMeshParam<float>(
@@ -900,20 +976,18 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
             // Object Generic
 
-            m_cyclesObject->is_shadow_catcher = _HdCyclesGetMeshParam<bool>(
+            m_isShadowCatcher = _HdCyclesGetMeshParam<bool>(
                 pv, dirtyBits, id, this, sceneDelegate,
                 usdCyclesTokens->primvarsCyclesObjectIs_shadow_catcher,
-                m_cyclesObject->is_shadow_catcher);
+                m_isShadowCatcher);
 
-            m_cyclesObject->pass_id = _HdCyclesGetMeshParam<bool>(
+            m_passIdPrimvar = _HdCyclesGetMeshParam<int>(
                 pv, dirtyBits, id, this, sceneDelegate,
-                usdCyclesTokens->primvarsCyclesObjectPass_id,
-                m_cyclesObject->pass_id);
+                usdCyclesTokens->primvarsCyclesObjectPass_id, m_passIdPrimvar);
 
-            m_cyclesObject->use_holdout = _HdCyclesGetMeshParam<bool>(
+            m_useHoldout = _HdCyclesGetMeshParam<bool>(
                 pv, dirtyBits, id, this, sceneDelegate,
-                usdCyclesTokens->primvarsCyclesObjectUse_holdout,
-                m_cyclesObject->use_holdout);
+                usdCyclesTokens->primvarsCyclesObjectUse_holdout, m_useHoldout);
 
             // Visibility
 
@@ -956,18 +1030,37 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                                               : 0;
             m_visibilityFlags |= m_visShadow ? ccl::PATH_RAY_SHADOW : 0;
             m_visibilityFlags |= m_visTransmission ? ccl::PATH_RAY_TRANSMIT : 0;
-
-            mesh_updated = true;
         }
     }
+
+    const bool visibility[6] = { m_visCamera, m_visDiffuse, m_visGlossy,
+                                 m_visScatter, m_visShadow, m_visTransmission };
+    if (!std::equal(visibility, visibility + 6, prevVisibility)
+        || m_isShadowCatcher != wasShadowCatcher
+        || m_useHoldout != usedHoldout) {
+        m_stagedChanges |= HdCyclesRenderParam::VisibilityChanged;
+    }
 #endif
 
     // -------------------------------------
     // -- Create Cycles Mesh
 
+    // Subdivided meshes are diced from the control cage when the scene is
+    // updated, new points need a new cage
+    if (newMesh && m_useSubdivision && m_subdivEnabled)
+        newTopology = true;
+
     HdMeshUtil meshUtil(&m_topology, id);
     if (newMesh) {
-        m_cyclesMesh->clear();
+        // Build into a mesh that is not part of the scene yet. CommitStaged
+        // either replaces m_cyclesMesh with it or moves its vertex and
+        // attribute data into m_cyclesMesh
+        if (m_stagedMesh) {
+            delete m_stagedMesh;
+        }
+        m_stagedTopology |= newTopology;
+        m_stagedMesh                   = _CreateCyclesMesh();
+        m_stagedMesh->subdivision_type = m_subdivisionType;
 
         _PopulateVertices();
 
@@ -989,7 +1082,7 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                     if (m_materialMap.find(subset.materialId)
                         == m_materialMap.end()) {
                         m_usedShaders.push_back(subMat->GetCyclesShader());
-                        subMat->GetCyclesShader()->tag_update(scene);
+                        m_usedShadersDirty = true;
 
                         m_materialMap.insert(
                             std::pair<SdfPath, int>(subset.materialId,
@@ -999,7 +1092,7 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                         subsetMaterialIndex = m_materialMap.at(
                             subset.materialId);
                     }
-                    m_cyclesMesh->used_shaders = m_usedShaders;
+                    m_stagedMesh->used_shaders = m_usedShaders;
                 }
             }
 
@@ -1013,11 +1106,11 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         if (m_useSubdivision && m_subdivEnabled) {
             _PopulateCreases();
 
-            if (!m_cyclesMesh->subd_params) {
-                m_cyclesMesh->subd_params = new ccl::SubdParams(m_cyclesMesh);
+            if (!m_stagedMesh->subd_params) {
+                m_stagedMesh->subd_params = new ccl::SubdParams(m_stagedMesh);
             }
 
-            ccl::SubdParams& subd_params = *m_cyclesMesh->subd_params;
+            ccl::SubdParams& subd_params = *m_stagedMesh->subd_params;
 
             subd_params.dicing_rate = m_dicingRate;
             subd_params.max_level   = m_maxSubdivision;
@@ -1035,9 +1128,10 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         }
 
         // Get all uvs (assumes all GfVec2f are uvs)
+        // The staged mesh starts empty, clean primvars are converted too
         for (auto& primvarDescsEntry : primvarDescsPerInterpolation) {
             for (auto& pv : primvarDescsEntry.second) {
-                if (HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, pv.name)) {
+                if (pv.name != HdTokens->points) {
                     auto value = GetPrimvar(sceneDelegate, pv.name);
                     VtValue triangulated;
 
@@ -1109,7 +1203,7 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                             }
 
                             // Add colors to attribute
-                            _AddColors(pv.name, colors, scene,
+                            _AddColors(pv.name, colors,
                                        primvarDescsEntry.first);
                         }
                         mesh_updated = true;
@@ -1129,11 +1223,10 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                             VtVec2fArray triangulatedUvs
                                 = triangulated.Get<VtVec2fArray>();
 
-                            _AddUVSet(pv.name, triangulatedUvs, scene,
+                            _AddUVSet(pv.name, triangulatedUvs,
                                       primvarDescsEntry.first);
                         } else {
-                            _AddUVSet(pv.name, uvs, scene,
-                                      primvarDescsEntry.first);
+                            _AddUVSet(pv.name, uvs, primvarDescsEntry.first);
                         }
                         mesh_updated = true;
                     }
@@ -1143,20 +1236,21 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
         // Apply existing shaders
         if (m_usedShaders.size() > 0)
-            m_cyclesMesh->used_shaders = m_usedShaders;
+            m_stagedMesh->used_shaders = m_usedShaders;
     }
 
     if (*dirtyBits & HdChangeTracker::DirtyTransform) {
-        // This causes a known slowdown to deforming motion blur renders
-        // This will be addressed in an upcoming PR
-        m_transformSamples = HdCyclesSetTransform(m_cyclesObject, sceneDelegate,
-                                                  id, m_useMotionBlur);
+        // Only sampled here, applied to the object in CommitStaged
+        m_transformSamples = {};
+        sceneDelegate->SampleTransform(id, &m_transformSamples);
 
-        if (m_cyclesMesh && m_cyclesMesh->subd_params) {
-            m_cyclesMesh->subd_params->objecttoworld = m_cyclesObject->tfm;
-        }
+        if (!sequenceMode
+            || HdCyclesUpdateHash(m_transformHash, HdCyclesHashTransformSamples(
+                                                       m_transformSamples))) {
+            m_transformDirty = true;
 
-        mesh_updated = true;
+            m_stagedChanges |= HdCyclesRenderParam::TransformChanged;
+        }
     }
 
     ccl::Shader* fallbackShader = scene->default_surface;
@@ -1165,9 +1259,11 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         fallbackShader = param->default_vcol_surface;
     }
 
-    if (*dirtyBits & HdChangeTracker::DirtyPrimID) {
-        // Offset of 1 added because Cycles primId pass needs to be shifted down to -1
-        m_cyclesObject->pass_id = this->GetPrimId() + 1;
+    // Either the primId or the pass_id primvar may have changed
+    const int passId = HdCyclesGetPassId(GetPrimId(), m_passIdPrimvar);
+    if (passId != m_passId) {
+        m_passId = passId;
+        m_stagedChanges |= HdCyclesRenderParam::VisibilityChanged;
     }
 
     if (*dirtyBits & HdChangeTracker::DirtyMaterialId) {
@@ -1186,8 +1282,6 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
                     if (material && material->GetCyclesShader()) {
                         m_usedShaders.push_back(material->GetCyclesShader());
-
-                        material->GetCyclesShader()->tag_update(scene);
                     } else {
                         m_usedShaders.push_back(fallbackShader);
                     }
@@ -1195,21 +1289,21 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                     m_usedShaders.push_back(fallbackShader);
                 }
 
-                m_cyclesMesh->used_shaders = m_usedShaders;
+                m_usedShadersDirty = true;
             }
         }
     }
 
     if (*dirtyBits & HdChangeTracker::DirtyVisibility) {
-        mesh_updated        = true;
         _sharedData.visible = sceneDelegate->GetVisible(id);
+        m_stagedChanges |= HdCyclesRenderParam::VisibilityChanged;
     }
 
     // -------------------------------------
     // -- Handle point instances
 
-    if (newMesh || (*dirtyBits & HdChangeTracker::DirtyInstancer)) {
-        mesh_updated = true;
+    if (newTopology || (*dirtyBits & HdChangeTracker::DirtyInstancer)) {
+        m_stagedChanges |= HdCyclesRenderParam::TopologyChanged;
         if (auto instancer = static_cast<HdCyclesInstancer*>(
                 sceneDelegate->GetRenderIndex().GetInstancer(
                     GetInstancerId()))) {
@@ -1217,17 +1311,12 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
             auto newNumInstances    = (instanceTransforms.count > 0)
                                        ? instanceTransforms.values[0].size()
                                        : 0;
-            // Clear all instances...
-            if (m_cyclesInstances.size() > 0) {
-                for (auto instance : m_cyclesInstances) {
-                    if (instance) {
-                        m_renderDelegate->GetCyclesRenderParam()->RemoveObject(
-                            instance);
-                        delete instance;
-                    }
-                }
-                m_cyclesInstances.clear();
+            // Existing instances are replaced in CommitStaged
+            for (auto instance : m_stagedInstances) {
+                delete instance;
             }
+            m_stagedInstances.clear();
+            m_instancesStaged = true;
 
             if (newNumInstances != 0) {
                 std::vector<TfSmallVector<GfMatrix4d, 1>> combinedTransforms;
@@ -1260,7 +1349,6 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
                     instanceObj->tfm = mat4d_to_transform(
                         combinedTransforms[j].data()[0]);
-                    instanceObj->geometry = m_cyclesMesh;
 
                     // TODO: Implement motion blur for point instanced objects
                     /*if (m_useMotionBlur) {
@@ -1275,10 +1363,7 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                         }
                     }*/
 
-                    m_cyclesInstances.push_back(instanceObj);
-
-                    m_renderDelegate->GetCyclesRenderParam()->AddObject(
-                        instanceObj);
+                    m_stagedInstances.push_back(instanceObj);
                 }
 
                 // Hide prototype
@@ -1291,23 +1376,170 @@ HdCyclesMesh::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
     // -------------------------------------
     // -- Finish Mesh
 
-    if (newMesh && m_cyclesMesh) {
-        _FinishMesh(scene);
+    if (newMesh && m_stagedMesh) {
+        _FinishMesh();
+    }
+
+    if (mesh_updated || m_usedShadersDirty)
+        m_stagedChanges |= HdCyclesRenderParam::GeometryChanged;
+
+    if (newTopology)
+        m_stagedChanges |= HdCyclesRenderParam::TopologyChanged;
+
+    if (m_stagedChanges != HdCyclesRenderParam::NoChanges)
+        param->Interrupt();
+
+    param->StagePrim(this);
+
+    *dirtyBits = HdChangeTracker::Clean;
+}
+
+void
+HdCyclesMesh::CommitStaged(ccl::Scene* scene)
+{
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesMesh::CommitStaged", GetId());
+
+    HdCyclesRenderParam* param = m_renderDelegate->GetCyclesRenderParam();
+
+    uint32_t changes = m_stagedChanges;
+    m_stagedChanges  = HdCyclesRenderParam::NoChanges;
+
+    // New vertex and attribute data reached the scene mesh
+    bool published = false;
+
+    // The staged mesh only carries new vertex and attribute data when its
+    // faces match the scene mesh
+    const bool sameTopology = m_stagedMesh && m_isInScene && !m_stagedTopology
+                              && m_stagedMesh->verts.size()
+                                     == m_cyclesMesh->verts.size()
+                              && m_stagedMesh->num_triangles()
+                                     == m_cyclesMesh->num_triangles();
+
+    if (sameTopology) {
+        // Keep the mesh and its BVH, the BVH is refit to the new points
+        m_cyclesMesh->verts.steal_data(m_stagedMesh->verts);
+        m_cyclesMesh->attributes.attributes.swap(
+            m_stagedMesh->attributes.attributes);
+        m_cyclesMesh->use_motion_blur   = m_stagedMesh->use_motion_blur;
+        m_cyclesMesh->motion_steps      = m_stagedMesh->motion_steps;
+        m_cyclesMesh->bounds            = m_stagedMesh->bounds;
+        m_cyclesMesh->transform_applied = false;
+
+        delete m_stagedMesh;
+        m_stagedMesh = nullptr;
+
+        changes |= HdCyclesRenderParam::GeometryChanged;
+        published = true;
+    } else if (m_stagedMesh) {
+        if (m_isInScene) {
+            param->RemoveMesh(m_cyclesMesh);
+            param->AddMesh(m_stagedMesh);
+        } else {
+            delete m_cyclesMesh;
+        }
+
+        m_cyclesMesh = m_stagedMesh;
+        m_stagedMesh = nullptr;
+
+        m_cyclesObject->geometry = m_cyclesMesh;
+        for (auto instance : m_cyclesInstances) {
+            instance->geometry = m_cyclesMesh;
+        }
+
+        changes |= HdCyclesRenderParam::TopologyChanged;
+        published = true;
+    }
+    m_stagedTopology = false;
+
+    if (!m_isInScene) {
+        param->AddMesh(m_cyclesMesh);
+        param->AddObject(m_cyclesObject);
+        m_isInScene = true;
+    }
+
+    if (m_instancesStaged) {
+        for (auto instance : m_cyclesInstances) {
+            param->RemoveObject(instance);
+        }
+
+        m_cyclesInstances.swap(m_stagedInstances);
+        m_stagedInstances.clear();
+
+        for (auto instance : m_cyclesInstances) {
+            instance->geometry = m_cyclesMesh;
+            param->AddObject(instance);
+        }
+
+        m_instancesStaged = false;
     }
 
-    if (mesh_updated || newMesh) {
-        m_cyclesObject->visibility = m_visibilityFlags;
-        if (!_sharedData.visible)
-            m_cyclesObject->visibility = 0;
+    if (m_usedShadersDirty) {
+        m_cyclesMesh->used_shaders = m_usedShaders;
+        for (ccl::Shader* shader : m_usedShaders) {
+            shader->tag_update(scene);
+        }
+        m_usedShadersDirty = false;
+    }
+
+    // The shaders only list the attributes they read once compiled by the
+    // session, which is done with the scene mutex held
+    if (published
+        && !m_cyclesMesh->need_attribute(scene, ccl::ATTR_STD_GENERATED)) {
+        m_cyclesMesh->attributes.remove(ccl::ATTR_STD_GENERATED);
+        m_cyclesMesh->subd_attributes.remove(ccl::ATTR_STD_GENERATED);
+    }
 
+    if (m_transformDirty) {
+        // This causes a known slowdown to deforming motion blur renders
+        // This will be addressed in an upcoming PR
+        HdCyclesSetTransform(m_cyclesObject, m_transformSamples,
+                             m_useMotionBlur);
+        m_transformDirty = false;
+    }
+
+    if (m_cyclesMesh->subd_params) {
+        m_cyclesMesh->subd_params->objecttoworld = m_cyclesObject->tfm;
+
+        // Dicing happens in world space
+        if (changes & HdCyclesRenderParam::TransformChanged)
+            changes |= HdCyclesRenderParam::GeometryChanged;
+    }
+
+    m_cyclesObject->is_shadow_catcher = m_isShadowCatcher;
+    m_cyclesObject->pass_id           = m_passId;
+    m_cyclesObject->use_holdout       = m_useHoldout;
+
+    // Instances share the primId of their prototype
+    for (auto instance : m_cyclesInstances) {
+        instance->pass_id = m_passId;
+    }
+
+    if (changes == HdCyclesRenderParam::NoChanges)
+        return;
+
+    m_cyclesObject->visibility = m_visibilityFlags;
+    if (!_sharedData.visible)
+        m_cyclesObject->visibility = 0;
+
+    // Geometry is only tagged when its data changed, object level changes
+    // are left to the managers so the mesh BVH and attributes are kept
+    if (changes & HdCyclesRenderParam::TopologyChanged) {
+        m_cyclesMesh->tag_update(scene, true);
+    } else if (changes & HdCyclesRenderParam::GeometryChanged) {
         m_cyclesMesh->tag_update(scene, false);
+    } else if (m_cyclesMesh->transform_applied) {
+        // The object transform is baked into the mesh
         m_cyclesObject->tag_update(scene);
-        param->Interrupt();
     }
 
-    scene->mutex.unlock();
+    for (ccl::Shader* shader : m_cyclesMesh->used_shaders) {
+        if (shader->use_mis && shader->has_surface_emission) {
+            changes |= HdCyclesRenderParam::LightChanged;
+            break;
+        }
+    }
 
-    *dirtyBits = HdChangeTracker::Clean;
+    param->MarkChanged(changes);
 }
 
 PXR_NAMESPACE_CLOSE_SCOPE
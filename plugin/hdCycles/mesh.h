@@ -20,10 +20,12 @@
 #ifndef HD_CYCLES_MESH_H
 #define HD_CYCLES_MESH_H
 
+#include "renderParam.h"
 #include "utils.h"
 
 #include "hdcycles.h"
 
+#include <render/mesh.h>
 #include <util/util_transform.h>
 
 #include <pxr/base/gf/matrix4d.h>
@@ -50,7 +52,7 @@ class HdCyclesRenderDelegate;
  * @brief HdCycles Mesh Rprim mapped to Cycles mesh
  * 
  */
-class HdCyclesMesh final : public HdMesh {
+class HdCyclesMesh final : public HdMesh, public HdCyclesStagedPrim {
 public:
     HF_MALLOC_TAG_NEW("new HdCyclesMesh");
 
@@ -92,6 +94,14 @@ public:
     void Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
               HdDirtyBits* dirtyBits, TfToken const& reprToken) override;
 
+    /**
+     * @brief Publish the mesh, instances and object state built in Sync
+     * into the Cycles scene. Called with the scene mutex held.
+     * 
+     * @param scene Cycles scene
+     */
+    void CommitStaged(ccl::Scene* scene) override;
+
 protected:
     /**
      * @brief Create the cycles mesh representation
@@ -110,9 +120,8 @@ protected:
     /**
      * @brief Perform final mesh computations (bounds, tangents, etc)
      * 
-     * @param scene 
      */
-    void _FinishMesh(ccl::Scene* scene);
+    void _FinishMesh();
 
     /**
      * @brief Comptue Mikktspace tangents
@@ -128,7 +137,7 @@ protected:
      * @param uvs 
      * @param interpolation 
      */
-    void _AddUVSet(TfToken name, VtVec2fArray& uvs, ccl::Scene* scene,
+    void _AddUVSet(TfToken name, VtVec2fArray& uvs,
                    HdInterpolation interpolation);
 
     /**
@@ -153,10 +162,9 @@ protected:
      * 
      * @param name 
      * @param colors 
-     * @param scene 
      * @param interpolation 
      */
-    void _AddColors(TfToken name, VtVec3fArray& colors, ccl::Scene* scene,
+    void _AddColors(TfToken name, VtVec3fArray& colors,
                     HdInterpolation interpolation);
 
 protected:
@@ -227,14 +235,40 @@ protected:
 
     /**
      * @brief Populate generated coordinates attribute
+     * Whether a shader needs them is only known with the scene mutex held,
+     * so they are always populated and dropped by CommitStaged.
      * 
      */
-    void _PopulateGenerated(ccl::Scene* scene);
+    void _PopulateGenerated();
 
     ccl::Mesh* m_cyclesMesh;
     ccl::Object* m_cyclesObject;
     std::vector<ccl::Object*> m_cyclesInstances;
 
+    // Staging data, built in Sync and published in CommitStaged
+    ccl::Mesh* m_stagedMesh = nullptr;
+    std::vector<ccl::Object*> m_stagedInstances;
+    bool m_stagedTopology   = false;
+    bool m_instancesStaged  = false;
+    bool m_usedShadersDirty = false;
+    bool m_transformDirty   = false;
+    bool m_isInScene        = false;
+
+    uint32_t m_stagedChanges = HdCyclesRenderParam::NoChanges;
+
+    // Content hashes of the last converted data, used in sequence mode
+    size_t m_pointsHash     = 0;
+    size_t m_primvarsHash   = 0;
+    size_t m_topologyHash   = 0;
+    size_t m_subdivTagsHash = 0;
+    size_t m_transformHash  = 0;
+
+    ccl::Mesh::SubdivisionType m_subdivisionType = ccl::Mesh::SUBDIVISION_NONE;
+    bool m_isShadowCatcher                       = false;
+    int m_passId                                 = -1;
+    int m_passIdPrimvar                          = -1;
+    bool m_useHoldout                            = false;
+
     std::map<SdfPath, int> m_materialMap;
 
     size_t m_numMeshVerts = 0;
@@ -36,6 +36,8 @@ HdCyclesOpenvdbAsset::Sync(HdSceneDelegate* a_sceneDelegate,
                            HdRenderParam* a_renderParam,
                            HdDirtyBits* a_dirtyBits)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesOpenvdbAsset::Sync", GetId());
+
     TF_UNUSED(a_renderParam);
     if (*a_dirtyBits & HdField::DirtyParams) {
         auto& changeTracker
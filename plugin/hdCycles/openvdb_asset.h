@@ -26,6 +26,7 @@
 #include <pxr/imaging/hd/field.h>
 
 #include "renderDelegate.h"
+#include "trace.h"
 
 #include <mutex>
 #include <unordered_set>
@@ -44,6 +45,8 @@ public:
     HdCyclesVolumeLoader(const char* filepath, const char* grid_name)
         : ccl::VDBImageLoader(grid_name)
     {
+        HD_CYCLES_TRACE_SCOPE("HdCyclesVolumeLoader::LoadGrid");
+
         openvdb::io::File file(filepath);
 
         try {
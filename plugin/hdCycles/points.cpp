@@ -22,6 +22,7 @@
 #include "config.h"
 #include "material.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/mesh.h>
@@ -75,8 +76,6 @@ HdCyclesPoints::~HdCyclesPoints()
     // Remove mesh
 
     m_renderDelegate->GetCyclesRenderParam()->RemoveMesh(m_cyclesMesh);
-
-    delete m_cyclesMesh;
 }
 
 void
@@ -99,6 +98,8 @@ void
 HdCyclesPoints::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                      HdDirtyBits* dirtyBits, TfToken const& reprSelector)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesPoints::Sync", GetId());
+
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
 
     const SdfPath& id = GetId();
@@ -107,8 +108,22 @@ HdCyclesPoints::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
 
     ccl::Scene* scene = param->GetCyclesScene();
 
-    bool needs_update  = false;
-    bool needs_newMesh = true;
+    // Render tag and repr only changes leave the scene as is
+    if (!(*dirtyBits & GetInitialDirtyBitsMask())) {
+        *dirtyBits = HdChangeTracker::Clean;
+        return;
+    }
+
+    // Points rebuild their mesh and objects in place
+    std::unique_lock<ccl::thread_mutex> sceneLock = param->LockScene();
+
+    bool needs_update = false;
+
+    // Widths and normals are applied on top of the point positions, the
+    // objects are recreated so they don't accumulate
+    bool needs_newMesh
+        = HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, HdTokens->widths)
+          || HdChangeTracker::IsPrimvarDirty(*dirtyBits, id, HdTokens->normals);
 
     // Read Cycles Primvars
 
@@ -176,6 +191,7 @@ HdCyclesPoints::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                     ccl::transform_translate(vec3f_to_float3(points[i])),
                     m_cyclesMesh);
 
+                pointObject->pass_id   = HdCyclesGetPassId(GetPrimId());
                 pointObject->random_id = i;
                 pointObject->name
                     = ccl::ustring::format("%s@%08x", pointObject->name,
@@ -186,6 +202,14 @@ HdCyclesPoints::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         }
     }
 
+    if (*dirtyBits & HdChangeTracker::DirtyPrimID) {
+        for (int i = 0; i < m_cyclesObjects.size(); i++) {
+            m_cyclesObjects[i]->pass_id = HdCyclesGetPassId(GetPrimId());
+        }
+
+        needs_update = true;
+    }
+
     if (*dirtyBits & HdChangeTracker::DirtyTransform) {
         ccl::Transform newTransform = HdCyclesExtractTransform(sceneDelegate,
                                                                id);
@@ -266,8 +290,12 @@ HdCyclesPoints::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         }
     }
 
-    if (needs_update)
+    if (needs_update) {
+        // Every point is an object of its own
+        param->MarkChanged(HdCyclesRenderParam::TransformChanged
+                           | HdCyclesRenderParam::VisibilityChanged);
         param->Interrupt();
+    }
 
     *dirtyBits = HdChangeTracker::Clean;
 }
@@ -279,7 +307,7 @@ HdCyclesPoints::GetInitialDirtyBitsMask() const
            | HdChangeTracker::DirtyVisibility | HdChangeTracker::DirtyPrimvar
            | HdChangeTracker::DirtyWidths | HdChangeTracker::DirtyMaterialId
            | HdChangeTracker::DirtyInstanceIndex
-           | HdChangeTracker::DirtyNormals;
+           | HdChangeTracker::DirtyNormals | HdChangeTracker::DirtyPrimID;
 }
 
 bool
@@ -18,57 +18,424 @@
 //  limitations under the License.
 
 #include "renderBuffer.h"
+#include "config.h"
 #include "renderDelegate.h"
 #include "renderPass.h"
 
+#include <pxr/base/gf/half.h>
 #include <pxr/base/gf/vec2i.h>
 #include <pxr/base/gf/vec3i.h>
+#include <pxr/base/work/loops.h>
+
+#include <algorithm>
+
+// MSVC doesn't define __SSE2__ or __F16C__, SSE2 is implied by x64 and
+// /arch:SSE2, F16C by /arch:AVX2
+#if defined(__SSE2__) || defined(_M_X64) \
+    || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define HD_CYCLES_SSE2
+#endif
+#if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+#    define HD_CYCLES_F16C
+#endif
+
+#if defined(HD_CYCLES_SSE2)
+#    include <immintrin.h>
+#endif
 
 PXR_NAMESPACE_OPEN_SCOPE
 
 namespace {
-template<typename T>
+
+/**
+ * @brief Storage type and float conversion of a component format, resolved at
+ * compile time so the row kernels don't branch per component
+ */
+template<HdFormat ComponentFormat> struct _Component;
+
+template<> struct _Component<HdFormatUNorm8> {
+    using Type = uint8_t;
+    static float ToFloat(Type a_value) { return a_value / 255.0f; }
+    static Type FromFloat(float a_value)
+    {
+        return static_cast<Type>(std::min(std::max(a_value, 0.0f), 1.0f)
+                                 * 255.0f);
+    }
+};
+
+template<> struct _Component<HdFormatSNorm8> {
+    using Type = int8_t;
+    static float ToFloat(Type a_value) { return a_value / 127.0f; }
+    static Type FromFloat(float a_value)
+    {
+        return static_cast<Type>(std::min(std::max(a_value, -1.0f), 1.0f)
+                                 * 127.0f);
+    }
+};
+
+template<> struct _Component<HdFormatFloat16> {
+    using Type = uint16_t;
+    static float ToFloat(Type a_value)
+    {
+        GfHalf half;
+        half.setBits(a_value);
+        return static_cast<float>(half);
+    }
+    static Type FromFloat(float a_value) { return GfHalf(a_value).bits(); }
+};
+
+template<> struct _Component<HdFormatFloat32> {
+    using Type = float;
+    static float ToFloat(Type a_value) { return a_value; }
+    static Type FromFloat(float a_value) { return a_value; }
+};
+
+template<> struct _Component<HdFormatInt32> {
+    using Type = int32_t;
+    static float ToFloat(Type a_value) { return static_cast<float>(a_value); }
+    static Type FromFloat(float a_value) { return static_cast<Type>(a_value); }
+};
+
+template<HdFormat Src, HdFormat Dst>
+inline typename _Component<Dst>::Type
+_ConvertComponent(typename _Component<Src>::Type a_value)
+{
+    return _Component<Dst>::FromFloat(_Component<Src>::ToFloat(a_value));
+}
+
+// If src and dst are both int-based, don't round trip to float.
+template<>
+inline int32_t
+_ConvertComponent<HdFormatInt32, HdFormatInt32>(int32_t a_value)
+{
+    return a_value;
+}
+
+/**
+ * @brief Converts a row of pixels, components beyond the source count are
+ * zeroed. The counts are ignored by the kernels that fix them at compile time.
+ */
+using _RowConverter = void (*)(uint8_t* a_dst, uint8_t const* a_src,
+                               size_t a_numPixels, size_t a_dstCount,
+                               size_t a_srcCount);
+
+template<HdFormat Src, HdFormat Dst>
 void
-_ConvertPixel(HdFormat dstFormat, uint8_t* dst, HdFormat srcFormat,
-              uint8_t const* src)
-{
-    HdFormat srcComponentFormat = HdGetComponentFormat(srcFormat);
-    HdFormat dstComponentFormat = HdGetComponentFormat(dstFormat);
-    size_t srcComponentCount    = HdGetComponentCount(srcFormat);
-    size_t dstComponentCount    = HdGetComponentCount(dstFormat);
-
-    for (size_t c = 0; c < dstComponentCount; ++c) {
-        T readValue = 0;
-        if (c < srcComponentCount) {
-            if (srcComponentFormat == HdFormatInt32) {
-                readValue = ((int32_t*)src)[c];
-            } else if (srcComponentFormat == HdFormatFloat16) {
-                GfHalf half;
-                half.setBits(((uint16_t*)src)[c]);
-                readValue = static_cast<float>(half);
-            } else if (srcComponentFormat == HdFormatFloat32) {
-                // We need to subtract one from here due to cycles prim defaulting to 0 but hydra to -1
-                readValue = ((float*)src)[c];
-            } else if (srcComponentFormat == HdFormatUNorm8) {
-                readValue = ((uint8_t*)src)[c] / 255.0f;
-            } else if (srcComponentFormat == HdFormatSNorm8) {
-                readValue = ((int8_t*)src)[c] / 127.0f;
-            }
+_ConvertRowGeneric(uint8_t* a_dst, uint8_t const* a_src, size_t a_numPixels,
+                   size_t a_dstCount, size_t a_srcCount)
+{
+    using SrcType = typename _Component<Src>::Type;
+    using DstType = typename _Component<Dst>::Type;
+
+    auto src = reinterpret_cast<SrcType const*>(a_src);
+    auto dst = reinterpret_cast<DstType*>(a_dst);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        for (size_t c = 0; c < a_dstCount; ++c) {
+            dst[c] = c < a_srcCount ? _ConvertComponent<Src, Dst>(src[c])
+                                    : DstType(0);
+        }
+        src += a_srcCount;
+        dst += a_dstCount;
+    }
+}
+
+template<HdFormat Src, HdFormat Dst, size_t SrcCount, size_t DstCount>
+void
+_ConvertRow(uint8_t* a_dst, uint8_t const* a_src, size_t a_numPixels, size_t,
+            size_t)
+{
+    using SrcType = typename _Component<Src>::Type;
+    using DstType = typename _Component<Dst>::Type;
+
+    auto src = reinterpret_cast<SrcType const*>(a_src);
+    auto dst = reinterpret_cast<DstType*>(a_dst);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        for (size_t c = 0; c < DstCount; ++c) {
+            dst[c] = c < SrcCount ? _ConvertComponent<Src, Dst>(src[c])
+                                  : DstType(0);
         }
+        src += SrcCount;
+        dst += DstCount;
+    }
+}
+
+#if defined(HD_CYCLES_SSE2)
+
+/**
+ * @brief Scale 4 floats to [0, 255], clamp and store them as 4 bytes
+ */
+inline void
+_StoreUNorm8x4(uint8_t* a_dst, __m128 a_value)
+{
+    const __m128 scaled = _mm_mul_ps(
+        _mm_min_ps(_mm_max_ps(a_value, _mm_setzero_ps()), _mm_set1_ps(1.0f)),
+        _mm_set1_ps(255.0f));
+    const __m128i ints  = _mm_cvttps_epi32(scaled);
+    const __m128i words = _mm_packs_epi32(ints, ints);
+    const int bytes     = _mm_cvtsi128_si32(_mm_packus_epi16(words, words));
+    memcpy(a_dst, &bytes, 4);
+}
+
+/**
+ * @brief Load 4 halfs as floats
+ * Uses F16C when the build enables it. Otherwise the half bits are moved
+ * into a float and rescaled, exact for every half including denormals,
+ * infinities and NaNs.
+ */
+inline __m128
+_LoadHalf4(uint16_t const* a_src)
+{
+    const __m128i bits = _mm_loadl_epi64(
+        reinterpret_cast<__m128i const*>(a_src));
+#    if defined(HD_CYCLES_F16C)
+    return _mm_cvtph_ps(bits);
+#    else
+    const __m128i halfs   = _mm_unpacklo_epi16(bits, _mm_setzero_si128());
+    const __m128i expMant = _mm_and_si128(halfs, _mm_set1_epi32(0x7fff));
+    const __m128i sign = _mm_slli_epi32(_mm_xor_si128(halfs, expMant), 16);
+
+    // Rebias the exponent by multiplying with 2^112
+    const __m128 scaled = _mm_mul_ps(
+        _mm_castsi128_ps(_mm_slli_epi32(expMant, 13)),
+        _mm_castsi128_ps(_mm_set1_epi32((254 - 15) << 23)));
+
+    const __m128i isInfNan  = _mm_cmpgt_epi32(expMant,
+                                              _mm_set1_epi32(0x7bff));
+    const __m128i infNanExp = _mm_and_si128(isInfNan,
+                                            _mm_set1_epi32(255 << 23));
+    return _mm_or_ps(scaled,
+                     _mm_castsi128_ps(_mm_or_si128(sign, infNanExp)));
+#    endif
+}
+
+/**
+ * @brief Store 4 floats as halfs
+ * Uses F16C when the build enables it. Otherwise the float is rescaled and
+ * its bits shifted into a half, out of range values become infinities.
+ * Ties round away from zero instead of to even.
+ */
+inline void
+_StoreHalf4(uint16_t* a_dst, __m128 a_value)
+{
+#    if defined(HD_CYCLES_F16C)
+    const __m128i packed = _mm_cvtps_ph(a_value, 0);
+#    else
+    const __m128i infinity  = _mm_set1_epi32(255 << 23);
+    const __m128i roundMask = _mm_set1_epi32(~0xfff);
+
+    const __m128i bits    = _mm_castps_si128(a_value);
+    const __m128i sign    = _mm_and_si128(bits, _mm_set1_epi32(0x80000000u));
+    const __m128i absBits = _mm_xor_si128(bits, sign);
+
+    const __m128i isNan    = _mm_cmpgt_epi32(absBits, infinity);
+    const __m128i isFinite = _mm_cmpgt_epi32(infinity, absBits);
+    const __m128i infNan
+        = _mm_or_si128(_mm_and_si128(isNan, _mm_set1_epi32(0x200)),
+                       _mm_set1_epi32(0x7c00));
+
+    // Rebias the exponent by multiplying with 2^-112, clamped below the
+    // half infinity, then round and drop the extra mantissa bits
+    const __m128 truncated = _mm_and_ps(_mm_castsi128_ps(absBits),
+                                        _mm_castsi128_ps(roundMask));
+    const __m128 scaled    = _mm_mul_ps(
+        truncated, _mm_castsi128_ps(_mm_set1_epi32(15 << 23)));
+    const __m128 clamped = _mm_min_ps(
+        scaled, _mm_castsi128_ps(_mm_set1_epi32((31 << 23) - 0x1000)));
+    const __m128i rounded = _mm_srli_epi32(
+        _mm_sub_epi32(_mm_castps_si128(clamped), roundMask), 13);
+
+    const __m128i halfs
+        = _mm_or_si128(_mm_or_si128(_mm_and_si128(rounded, isFinite),
+                                    _mm_andnot_si128(isFinite, infNan)),
+                       _mm_srli_epi32(sign, 16));
+
+    // Sign extend so the saturating pack keeps the 16 bits as they are
+    const __m128i packed = _mm_packs_epi32(
+        _mm_srai_epi32(_mm_slli_epi32(halfs, 16), 16), _mm_setzero_si128());
+#    endif
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(a_dst), packed);
+}
+
+template<>
+void
+_ConvertRow<HdFormatFloat32, HdFormatUNorm8, 4, 4>(uint8_t* a_dst,
+                                                   uint8_t const* a_src,
+                                                   size_t a_numPixels, size_t,
+                                                   size_t)
+{
+    auto src = reinterpret_cast<float const*>(a_src);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        _StoreUNorm8x4(&a_dst[i * 4], _mm_loadu_ps(&src[i * 4]));
+    }
+}
+
+template<>
+void
+_ConvertRow<HdFormatFloat16, HdFormatUNorm8, 4, 4>(uint8_t* a_dst,
+                                                   uint8_t const* a_src,
+                                                   size_t a_numPixels, size_t,
+                                                   size_t)
+{
+    auto src = reinterpret_cast<uint16_t const*>(a_src);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        _StoreUNorm8x4(&a_dst[i * 4], _LoadHalf4(&src[i * 4]));
+    }
+}
+
+template<>
+void
+_ConvertRow<HdFormatFloat16, HdFormatFloat32, 4, 4>(uint8_t* a_dst,
+                                                    uint8_t const* a_src,
+                                                    size_t a_numPixels, size_t,
+                                                    size_t)
+{
+    auto src = reinterpret_cast<uint16_t const*>(a_src);
+    auto dst = reinterpret_cast<float*>(a_dst);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        _mm_storeu_ps(&dst[i * 4], _LoadHalf4(&src[i * 4]));
+    }
+}
+
+template<>
+void
+_ConvertRow<HdFormatFloat32, HdFormatFloat16, 4, 4>(uint8_t* a_dst,
+                                                    uint8_t const* a_src,
+                                                    size_t a_numPixels, size_t,
+                                                    size_t)
+{
+    auto src = reinterpret_cast<float const*>(a_src);
+    auto dst = reinterpret_cast<uint16_t*>(a_dst);
+    for (size_t i = 0; i < a_numPixels; ++i) {
+        _StoreHalf4(&dst[i * 4], _mm_loadu_ps(&src[i * 4]));
+    }
+}
+
+#endif  // HD_CYCLES_SSE2
+
+// Format pairs hit by the display and AOV blits, with the component counts
+// known at compile time
+struct _RowKernel {
+    HdFormat src;
+    HdFormat dst;
+    _RowConverter convert;
+};
+
+// clang-format off
+const _RowKernel RowKernels[] = {
+    { HdFormatFloat32Vec4, HdFormatFloat16Vec4,
+      &_ConvertRow<HdFormatFloat32, HdFormatFloat16, 4, 4> },
+    { HdFormatFloat32Vec4, HdFormatUNorm8Vec4,
+      &_ConvertRow<HdFormatFloat32, HdFormatUNorm8, 4, 4> },
+    { HdFormatFloat16Vec4, HdFormatUNorm8Vec4,
+      &_ConvertRow<HdFormatFloat16, HdFormatUNorm8, 4, 4> },
+    { HdFormatFloat16Vec4, HdFormatFloat32Vec4,
+      &_ConvertRow<HdFormatFloat16, HdFormatFloat32, 4, 4> },
+    { HdFormatFloat32Vec3, HdFormatFloat16Vec3,
+      &_ConvertRow<HdFormatFloat32, HdFormatFloat16, 3, 3> },
+    { HdFormatFloat32Vec3, HdFormatFloat32Vec4,
+      &_ConvertRow<HdFormatFloat32, HdFormatFloat32, 3, 4> },
+    { HdFormatFloat32Vec3, HdFormatUNorm8Vec4,
+      &_ConvertRow<HdFormatFloat32, HdFormatUNorm8, 3, 4> },
+    { HdFormatFloat32,     HdFormatFloat16,
+      &_ConvertRow<HdFormatFloat32, HdFormatFloat16, 1, 1> },
+    { HdFormatFloat32,     HdFormatInt32,
+      &_ConvertRow<HdFormatFloat32, HdFormatInt32, 1, 1> },
+};
+// clang-format on
+
+template<HdFormat Src>
+_RowConverter
+_GetGenericRowConverter(HdFormat a_dstComponent)
+{
+    switch (a_dstComponent) {
+    case HdFormatUNorm8: return &_ConvertRowGeneric<Src, HdFormatUNorm8>;
+    case HdFormatSNorm8: return &_ConvertRowGeneric<Src, HdFormatSNorm8>;
+    case HdFormatFloat16: return &_ConvertRowGeneric<Src, HdFormatFloat16>;
+    case HdFormatFloat32: return &_ConvertRowGeneric<Src, HdFormatFloat32>;
+    case HdFormatInt32: return &_ConvertRowGeneric<Src, HdFormatInt32>;
+    default: return nullptr;
+    }
+}
 
-        if (dstComponentFormat == HdFormatInt32) {
-            ((int32_t*)dst)[c] = readValue;
-        } else if (dstComponentFormat == HdFormatFloat16) {
-            ((uint16_t*)dst)[c] = GfHalf(float(readValue)).bits();
-        } else if (dstComponentFormat == HdFormatFloat32) {
-            ((float*)dst)[c] = readValue;
-        } else if (dstComponentFormat == HdFormatUNorm8) {
-            ((uint8_t*)dst)[c] = (readValue * 255.0f);
-        } else if (dstComponentFormat == HdFormatSNorm8) {
-            ((int8_t*)dst)[c] = (readValue * 127.0f);
+/**
+ * @brief Pick the row kernel converting from a_src to a_dst, or nullptr if
+ * either format is unsupported
+ */
+_RowConverter
+_GetRowConverter(HdFormat a_dst, HdFormat a_src)
+{
+    for (const _RowKernel& kernel : RowKernels) {
+        if (kernel.src == a_src && kernel.dst == a_dst) {
+            return kernel.convert;
         }
     }
+
+    const HdFormat dstComponent = HdGetComponentFormat(a_dst);
+    switch (HdGetComponentFormat(a_src)) {
+    case HdFormatUNorm8:
+        return _GetGenericRowConverter<HdFormatUNorm8>(dstComponent);
+    case HdFormatSNorm8:
+        return _GetGenericRowConverter<HdFormatSNorm8>(dstComponent);
+    case HdFormatFloat16:
+        return _GetGenericRowConverter<HdFormatFloat16>(dstComponent);
+    case HdFormatFloat32:
+        return _GetGenericRowConverter<HdFormatFloat32>(dstComponent);
+    case HdFormatInt32:
+        return _GetGenericRowConverter<HdFormatInt32>(dstComponent);
+    default: return nullptr;
+    }
+}
+
+HdFormat
+_GetFloat32Format(size_t a_componentCount)
+{
+    switch (a_componentCount) {
+    case 1: return HdFormatFloat32;
+    case 2: return HdFormatFloat32Vec2;
+    case 3: return HdFormatFloat32Vec3;
+    case 4: return HdFormatFloat32Vec4;
+    default: return HdFormatInvalid;
+    }
+}
+
+// Below this many bytes a blit isn't worth splitting across threads
+constexpr size_t MinParallelBlitSize = 256 * 1024;
+
+/**
+ * @brief Calls a_fn with ranges of rows, in parallel for large blits
+ */
+template<typename Fn>
+void
+_ForEachRow(size_t a_numRows, size_t a_rowSize, Fn&& a_fn)
+{
+    if (a_numRows * a_rowSize < MinParallelBlitSize) {
+        a_fn(0, a_numRows);
+        return;
+    }
+    WorkParallelForN(a_numRows, std::forward<Fn>(a_fn));
+}
+
+/**
+ * @brief Source samples and weight of a destination pixel center
+ */
+struct _BilinearSample {
+    size_t first;
+    size_t second;
+    float weight;
+};
+
+_BilinearSample
+_GetBilinearSample(size_t a_dst, float a_scale, size_t a_srcSize)
+{
+    const float src = std::max((a_dst + 0.5f) * a_scale - 0.5f, 0.0f);
+
+    _BilinearSample sample;
+    sample.first  = std::min(static_cast<size_t>(src), a_srcSize - 1);
+    sample.second = std::min(sample.first + 1, a_srcSize - 1);
+    sample.weight = std::min(src - sample.first, 1.0f);
+    return sample;
 }
+
 }  // namespace
 
 HdCyclesRenderBuffer::HdCyclesRenderBuffer(
@@ -78,8 +445,10 @@ HdCyclesRenderBuffer::HdCyclesRenderBuffer(
     , m_height(0)
     , m_format(HdFormatInvalid)
     , m_pixelSize(0)
+    , m_swapPending(false)
     , m_mappers(0)
     , m_converged(false)
+    , m_upscaleBilinear(HdCyclesConfig::GetInstance().upscale_bilinear.value)
     , m_renderDelegate(renderDelegate)
 {
 }
@@ -98,11 +467,15 @@ HdCyclesRenderBuffer::Allocate(const GfVec3i& dimensions, HdFormat format,
         return false;
     }
 
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    std::lock_guard<std::mutex> swapLock(m_swapMutex);
+
     m_width     = dimensions[0];
     m_height    = dimensions[1];
     m_format    = format;
     m_pixelSize = HdDataSizeOfFormat(format);
     m_buffer.resize(m_width * m_height * m_pixelSize, 0);
+    m_backBuffer.resize(m_buffer.size(), 0);
 
     return true;
 }
@@ -140,6 +513,15 @@ HdCyclesRenderBuffer::IsMultiSampled() const
 void*
 HdCyclesRenderBuffer::Map()
 {
+    std::lock_guard<std::mutex> swapLock(m_swapMutex);
+    if (m_swapPending && m_mappers.load() == 0) {
+        // Never wait on a blit in progress, it swaps once it is done
+        std::unique_lock<std::mutex> writeLock(m_backBufferMutex,
+                                               std::try_to_lock);
+        if (writeLock.owns_lock()) {
+            _Swap();
+        }
+    }
     m_mappers++;
     return m_buffer.data();
 }
@@ -177,59 +559,169 @@ void
 HdCyclesRenderBuffer::Blit(HdFormat format, int width, int height, int offset,
                            int stride, uint8_t const* data)
 {
-    if (m_format == format) {
-        if (static_cast<unsigned int>(width) == m_width
-            && static_cast<unsigned int>(height) == m_height) {
-            // Blit line by line.
-            for (unsigned int j = 0; j < m_height; ++j) {
-                memcpy(&m_buffer[(j * m_width) * m_pixelSize],
-                       &data[(j * stride + offset) * m_pixelSize],
-                       m_width * m_pixelSize);
-            }
-        } else {
-            // Blit pixel by pixel, with nearest point sampling.
-            float scalei = width / float(m_width);
-            float scalej = height / float(m_height);
-            for (unsigned int j = 0; j < m_height; ++j) {
-                for (unsigned int i = 0; i < m_width; ++i) {
-                    unsigned int ii = scalei * i;
-                    unsigned int jj = scalej * j;
-                    memcpy(&m_buffer[(j * m_width + i) * m_pixelSize],
-                           &data[(jj * stride + offset + ii) * m_pixelSize],
-                           m_pixelSize);
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    if (m_backBuffer.empty()) {
+        return;
+    }
+
+    if (width <= 0 || height <= 0) {
+        return;
+    }
+
+    _RowConverter convert = nullptr;
+    if (m_format != format) {
+        convert = _GetRowConverter(m_format, format);
+        if (!convert) {
+            return;
+        }
+    }
+
+    const size_t pixelSize = HdDataSizeOfFormat(format);
+    const size_t srcCount  = HdGetComponentCount(format);
+    const size_t dstCount  = HdGetComponentCount(m_format);
+    const size_t rowSize   = m_width * m_pixelSize;
+
+    if (static_cast<unsigned int>(width) == m_width
+        && static_cast<unsigned int>(height) == m_height) {
+        // Blit line by line.
+        _ForEachRow(m_height, rowSize, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                uint8_t* dst       = &m_backBuffer[j * rowSize];
+                uint8_t const* src = &data[(j * stride + offset) * pixelSize];
+                if (convert) {
+                    convert(dst, src, m_width, dstCount, srcCount);
+                } else {
+                    memcpy(dst, src, rowSize);
                 }
             }
+        });
+    } else if (m_upscaleBilinear
+               && HdGetComponentFormat(format) != HdFormatInt32
+               && HdGetComponentFormat(m_format) != HdFormatInt32) {
+        // Ids and other integer data are never filtered
+        if (!_BlitBilinear(format, width, height, offset, stride, data)) {
+            return;
         }
     } else {
-        // Convert pixel by pixel, with nearest point sampling.
-        // If src and dst are both int-based, don't round trip to float.
-        size_t pixelSize  = HdDataSizeOfFormat(format);
-        bool convertAsInt = (HdGetComponentFormat(format) == HdFormatInt32)
-                            && (HdGetComponentFormat(m_format)
-                                == HdFormatInt32);
-
-        float scalei = width / float(m_width);
-        float scalej = height / float(m_height);
-        for (unsigned int j = 0; j < m_height; ++j) {
-            for (unsigned int i = 0; i < m_width; ++i) {
-                unsigned int ii = scalei * i;
-                unsigned int jj = scalej * j;
-                if (convertAsInt) {
-                    _ConvertPixel<int32_t>(
-                        m_format,
-                        static_cast<uint8_t*>(
-                            &m_buffer[(j * m_width + i) * m_pixelSize]),
-                        format, &data[(jj * stride + offset + ii) * pixelSize]);
-                } else {
-                    _ConvertPixel<float>(
-                        m_format,
-                        static_cast<uint8_t*>(
-                            &m_buffer[(j * m_width + i) * m_pixelSize]),
-                        format, &data[(jj * stride + offset + ii) * pixelSize]);
+        // Blit pixel by pixel, with nearest point sampling. The source column
+        // of each pixel is the same for every row.
+        std::vector<size_t> srcColumns(m_width);
+        const float scalei = width / float(m_width);
+        for (unsigned int i = 0; i < m_width; ++i) {
+            srcColumns[i] = std::min(static_cast<size_t>(scalei * i),
+                                     static_cast<size_t>(width - 1));
+        }
+
+        const float scalej = height / float(m_height);
+        _ForEachRow(m_height, rowSize, [&](size_t begin, size_t end) {
+            for (size_t j = begin; j < end; ++j) {
+                const size_t jj = std::min(static_cast<size_t>(scalej * j),
+                                           static_cast<size_t>(height - 1));
+                uint8_t const* srcRow
+                    = &data[(jj * stride + offset) * pixelSize];
+                uint8_t* dst = &m_backBuffer[j * rowSize];
+                for (unsigned int i = 0; i < m_width;
+                     ++i, dst += m_pixelSize) {
+                    uint8_t const* src = &srcRow[srcColumns[i] * pixelSize];
+                    if (convert) {
+                        convert(dst, src, 1, dstCount, srcCount);
+                    } else {
+                        memcpy(dst, src, m_pixelSize);
+                    }
                 }
             }
+        });
+    }
+
+    // The whole back buffer was overwritten, nothing is left to sync
+    m_staleRegions.clear();
+    m_writtenRegions.assign(1, Region { 0, 0, m_width, m_height });
+}
+
+bool
+HdCyclesRenderBuffer::_BlitBilinear(HdFormat format, int width, int height,
+                                    int offset, int stride,
+                                    uint8_t const* data)
+{
+    // Source rows are filtered as floats, then converted to the buffer format
+    const size_t count         = HdGetComponentCount(format);
+    const size_t dstCount      = HdGetComponentCount(m_format);
+    const HdFormat floatFormat = _GetFloat32Format(count);
+
+    _RowConverter toFloat   = nullptr;
+    _RowConverter fromFloat = nullptr;
+    if (format != floatFormat) {
+        toFloat = _GetRowConverter(floatFormat, format);
+        if (!toFloat) {
+            return false;
+        }
+    }
+    if (m_format != floatFormat) {
+        fromFloat = _GetRowConverter(m_format, floatFormat);
+        if (!fromFloat) {
+            return false;
         }
     }
+
+    std::vector<_BilinearSample> columns(m_width);
+    const float scalei = width / float(m_width);
+    for (unsigned int i = 0; i < m_width; ++i) {
+        columns[i] = _GetBilinearSample(i, scalei, width);
+    }
+
+    const size_t pixelSize = HdDataSizeOfFormat(format);
+    const size_t rowSize   = m_width * m_pixelSize;
+    const float scalej     = height / float(m_height);
+    _ForEachRow(m_height, rowSize, [&](size_t begin, size_t end) {
+        // Kept by each worker thread, upscales during the low resolution
+        // passes only allocate when the size grows
+        thread_local std::vector<float> first;
+        thread_local std::vector<float> second;
+        thread_local std::vector<float> filtered;
+        first.resize(width * count);
+        second.resize(width * count);
+        filtered.resize(m_width * count);
+
+        auto readRow = [&](size_t a_row, std::vector<float>& a_scratch) {
+            uint8_t const* src = &data[(a_row * stride + offset) * pixelSize];
+            if (!toFloat) {
+                return reinterpret_cast<float const*>(src);
+            }
+            toFloat(reinterpret_cast<uint8_t*>(a_scratch.data()), src, width,
+                    count, count);
+            return static_cast<float const*>(a_scratch.data());
+        };
+
+        for (size_t j = begin; j < end; ++j) {
+            const _BilinearSample row = _GetBilinearSample(j, scalej, height);
+            float const* src0         = readRow(row.first, first);
+            float const* src1         = readRow(row.second, second);
+
+            for (unsigned int i = 0; i < m_width; ++i) {
+                const _BilinearSample& column = columns[i];
+                for (size_t c = 0; c < count; ++c) {
+                    const float a = src0[column.first * count + c];
+                    const float b = src0[column.second * count + c];
+                    const float d = src1[column.first * count + c];
+                    const float e = src1[column.second * count + c];
+                    const float top    = a + (b - a) * column.weight;
+                    const float bottom = d + (e - d) * column.weight;
+                    filtered[i * count + c] = top
+                                              + (bottom - top) * row.weight;
+                }
+            }
+
+            uint8_t* dst = &m_backBuffer[j * rowSize];
+            if (fromFloat) {
+                fromFloat(dst, reinterpret_cast<uint8_t*>(filtered.data()),
+                          m_width, dstCount, count);
+            } else {
+                memcpy(dst, filtered.data(), rowSize);
+            }
+        }
+    });
+
+    return true;
 }
 
 void
@@ -238,8 +730,13 @@ HdCyclesRenderBuffer::Clear()
     if (m_format == HdFormatInvalid)
         return;
 
-    size_t pixelSize = HdDataSizeOfFormat(m_format);
-    memset(&m_buffer[0], 0, m_buffer.size() * pixelSize);
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    std::lock_guard<std::mutex> swapLock(m_swapMutex);
+    std::fill(m_buffer.begin(), m_buffer.end(), 0);
+    std::fill(m_backBuffer.begin(), m_backBuffer.end(), 0);
+    m_writtenRegions.clear();
+    m_staleRegions.clear();
+    m_swapPending = false;
 }
 
 void
@@ -247,6 +744,8 @@ HdCyclesRenderBuffer::BlitTile(HdFormat format, unsigned int x, unsigned int y,
                                int unsigned width, unsigned int height,
                                int offset, int stride, uint8_t const* data)
 {
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+
     // TODO: BlitTile shouldnt be called but it is...
     if (m_width <= 0) {
         return;
@@ -254,70 +753,125 @@ HdCyclesRenderBuffer::BlitTile(HdFormat format, unsigned int x, unsigned int y,
     if (m_height <= 0) {
         return;
     }
-    if (m_buffer.size() <= 0) {
+    if (m_backBuffer.size() <= 0) {
         return;
     }
 
-    const auto numPixels = static_cast<size_t>(m_width * m_height);
-    size_t pixelSize     = HdDataSizeOfFormat(format);
+    // Clip the tile to the buffer
+    if (x >= m_width || y >= m_height) {
+        return;
+    }
+    width  = std::min(width, m_width - x);
+    height = std::min(height, m_height - y);
+
+    _RowConverter convert = nullptr;
+    if (m_format != format) {
+        convert = _GetRowConverter(m_format, format);
+        if (!convert) {
+            return;
+        }
+    }
 
-    if (m_format == format) {
-        for (unsigned int j = 0; j < height; ++j) {
-            if ((x + width) <= m_width) {
-                if ((y + height) <= m_height) {
-                    int mem_start = (((y + j) * m_width) * pixelSize)
-                                    + (x * pixelSize);
+    const size_t pixelSize = HdDataSizeOfFormat(format);
+
+    _SyncStaleRegions();
+    m_writtenRegions.push_back(Region { x, y, width, height });
+
+    const size_t srcCount = HdGetComponentCount(format);
+    const size_t dstCount = HdGetComponentCount(m_format);
+    const size_t rowSize  = width * m_pixelSize;
+    _ForEachRow(height, rowSize, [&](size_t begin, size_t end) {
+        for (size_t j = begin; j < end; ++j) {
+            uint8_t* dst = &m_backBuffer[((y + j) * m_width + x) * m_pixelSize];
+            uint8_t const* src = &data[(j * stride + offset) * pixelSize];
+            if (convert) {
+                convert(dst, src, width, dstCount, srcCount);
+            } else {
+                memcpy(dst, src, rowSize);
+            }
+        }
+    });
+}
 
+bool
+HdCyclesRenderBuffer::ExchangeBackBuffer(HdFormat format, unsigned int width,
+                                         unsigned int height,
+                                         std::vector<uint8_t>& data)
+{
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    if (format != m_format || width != m_width || height != m_height
+        || data.size() != m_backBuffer.size() || m_backBuffer.empty()) {
+        return false;
+    }
 
-                    int tile_mem_start = (j * width) * pixelSize;
+    // The whole back buffer is replaced, nothing is left to sync
+    m_backBuffer.swap(data);
+    m_staleRegions.clear();
+    m_writtenRegions.assign(1, Region { 0, 0, m_width, m_height });
+    return true;
+}
 
-                    memcpy(&m_buffer[mem_start], &data[tile_mem_start],
-                           width * pixelSize);
-                }
-            }
-        }
+void
+HdCyclesRenderBuffer::SwapBuffers()
+{
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    std::lock_guard<std::mutex> swapLock(m_swapMutex);
+    if (m_mappers.load() == 0) {
+        _Swap();
     } else {
-        // Convert pixel by pixel, with nearest point sampling.
-        // If src and dst are both int-based, don't round trip to float.
-        bool convertAsInt = (HdGetComponentFormat(format) == HdFormatInt32)
-                            && (HdGetComponentFormat(m_format)
-                                == HdFormatInt32);
-
-        for (unsigned int j = 0; j < height; ++j) {
-            for (unsigned int i = 0; i < width; ++i) {
-                int mem_start = (((y + j) * m_width) * m_pixelSize)
-                                + ((x + i) * m_pixelSize);
-
-                int tile_mem_start = ((j * width) * pixelSize)
-                                     + (i * pixelSize);
-
-                if (convertAsInt) {
-                    _ConvertPixel<int32_t>(m_format,
-                                           static_cast<uint8_t*>(
-                                               &m_buffer[mem_start]),
-                                           format, &data[tile_mem_start]);
-                } else {
-                    if (mem_start >= m_buffer.size()) {
-                        // TODO: This is triggered more times than it should be
-                    } else {
-                        _ConvertPixel<float>(m_format,
-                                             static_cast<uint8_t*>(
-                                                 &m_buffer[mem_start]),
-                                             format, &data[tile_mem_start]);
-                    }
-                }
-            }
+        m_swapPending = true;
+    }
+}
+
+void
+HdCyclesRenderBuffer::_Swap()
+{
+    m_swapPending = false;
+    if (m_writtenRegions.empty()) {
+        return;
+    }
+
+    // Bring the back buffer up to date before it becomes the front one
+    _SyncStaleRegions();
+
+    // O(1), the vectors exchange their storage
+    m_buffer.swap(m_backBuffer);
+    m_staleRegions.swap(m_writtenRegions);
+    m_writtenRegions.clear();
+}
+
+void
+HdCyclesRenderBuffer::_SyncStaleRegions()
+{
+    for (const Region& region : m_staleRegions) {
+        if (region.x + region.width > m_width
+            || region.y + region.height > m_height) {
+            continue;
+        }
+
+        const size_t rowSize = region.width * m_pixelSize;
+        for (unsigned int j = 0; j < region.height; ++j) {
+            const size_t start = ((region.y + j) * m_width + region.x)
+                                 * m_pixelSize;
+            memcpy(&m_backBuffer[start], &m_buffer[start], rowSize);
         }
     }
+    m_staleRegions.clear();
 }
 
 void
 HdCyclesRenderBuffer::_Deallocate()
 {
+    std::lock_guard<std::mutex> writeLock(m_backBufferMutex);
+    std::lock_guard<std::mutex> swapLock(m_swapMutex);
     m_width  = 0;
     m_height = 0;
     m_format = HdFormatInvalid;
     m_buffer.resize(0);
+    m_backBuffer.resize(0);
+    m_writtenRegions.clear();
+    m_staleRegions.clear();
+    m_swapPending = false;
     m_mappers.store(0);
     m_converged.store(false);
 }
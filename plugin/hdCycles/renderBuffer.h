@@ -25,6 +25,10 @@
 #include <pxr/imaging/hd/renderBuffer.h>
 #include <pxr/pxr.h>
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
 class HdCyclesRenderDelegate;
@@ -95,7 +99,8 @@ public:
 
     /**
      * @brief Maps the render buffer to the system memory.
-     * This returns the Cycles representation of data stored in _buffer
+     * This returns the front buffer, which blits never write to. A pending
+     * swap is applied first when nobody else has the buffer mapped.
      * 
      * @return Pointer to the render buffer mapped to system memory
      */
@@ -140,6 +145,7 @@ public:
 
     /**
      * @brief Helper to blit the render buffer data
+     * Data of a different size is rescaled, rows are blitted in parallel.
      * 
      * @param format Input format
      * @param width Width of buffer
@@ -155,6 +161,28 @@ public:
                   unsigned int width, unsigned int height, int offset,
                   int stride, uint8_t const* data);
 
+    /**
+     * @brief Take full size data in the buffer format as the back buffer,
+     * exchanging storage instead of copying as Blit would
+     * 
+     * @param format Format of the data
+     * @param width Width of the data
+     * @param height Height of the data
+     * @param data Replaced by the previous back buffer
+     * @return Returns false and leaves data as is if the format or the size
+     * differ from the buffer
+     */
+    bool ExchangeBackBuffer(HdFormat format, unsigned int width,
+                            unsigned int height, std::vector<uint8_t>& data);
+
+    /**
+     * @brief Publish the blits made since the last swap to readers
+     * Blits write to a back buffer, this swaps it with the front buffer
+     * returned by Map. If the buffer is mapped the swap is deferred until
+     * the next Map with no other mappers.
+     */
+    void SwapBuffers();
+
 protected:
     /**
      * @brief Deallocate memory allocated by the render buffer
@@ -164,14 +192,53 @@ protected:
     void _Deallocate() override;
 
 private:
+    struct Region {
+        unsigned int x;
+        unsigned int y;
+        unsigned int width;
+        unsigned int height;
+    };
+
+    /**
+     * @brief Rescale data to the back buffer with bilinear filtering,
+     * m_backBufferMutex must be held
+     * 
+     * @return false if the formats can't be converted, nothing is written
+     */
+    bool _BlitBilinear(HdFormat format, int width, int height, int offset,
+                       int stride, uint8_t const* data);
+
+    /**
+     * @brief Swap front and back buffers, m_backBufferMutex must be held
+     */
+    void _Swap();
+
+    /**
+     * @brief Copy the regions that are newer in the front buffer back to the
+     * back buffer, so a partial blit does not publish stale pixels
+     */
+    void _SyncStaleRegions();
+
     unsigned int m_width;
     unsigned int m_height;
     HdFormat m_format;
     unsigned int m_pixelSize;
 
+    // Front buffer handed out by Map, blits write to the back buffer
     std::vector<uint8_t> m_buffer;
+    std::vector<uint8_t> m_backBuffer;
+    std::mutex m_backBufferMutex;
+    std::mutex m_swapMutex;
+    bool m_swapPending;
+
+    // Regions written to the back buffer since the last swap, and regions
+    // that the last swap left outdated in the back buffer
+    std::vector<Region> m_writtenRegions;
+    std::vector<Region> m_staleRegions;
+
     std::atomic<int> m_mappers;
     std::atomic<bool> m_converged;
+    bool m_upscaleBilinear;
 
     HdCyclesRenderDelegate* m_renderDelegate;
 };
@@ -43,6 +43,7 @@
 
 #include <pxr/base/gf/api.h>
 #include <pxr/base/gf/vec2i.h>
+#include <pxr/base/gf/vec3f.h>
 #include <pxr/base/tf/getenv.h>
 #include <pxr/base/vt/api.h>
 #include <pxr/imaging/hd/camera.h>
@@ -167,8 +168,8 @@ HdCyclesRenderDelegate::SetRenderSetting(const TfToken& key,
                                          const VtValue& value)
 {
     HdRenderDelegate::SetRenderSetting(key, value);
-    m_renderParam->SetRenderSetting(key, value);
-    m_renderParam->Interrupt();
+    if (m_renderParam->SetRenderSetting(key, value))
+        m_renderParam->Interrupt();
 }
 
 HdRenderSettingDescriptorList
@@ -365,24 +366,36 @@ HdCyclesRenderDelegate::GetDefaultAovDescriptor(TfToken const& name) const
 
     HdFormat colorFormat = use_linear ? HdFormatFloat16Vec4
                                       : HdFormatUNorm8Vec4;
-    if (use_tiles) {
+    if (use_tiles || GetCyclesRenderParam()->IsDisplayBufferFloat()) {
         colorFormat = HdFormatFloat32Vec4;
     }
 
+    // Everything but color is read from the float passes of Cycles
     if (name == HdAovTokens->color) {
         return HdAovDescriptor(colorFormat, false, VtValue(GfVec4f(0.0f)));
     } else if (name == HdAovTokens->normal) {
-        if (use_tiles) {
-            colorFormat = HdFormatFloat32Vec3;
-        }
-        return HdAovDescriptor(colorFormat, false, VtValue(GfVec4f(0.0f)));
+        return HdAovDescriptor(HdFormatFloat32Vec3, false,
+                               VtValue(GfVec3f(0.0f)));
     } else if (name == HdAovTokens->depth) {
         return HdAovDescriptor(HdFormatFloat32, false, VtValue(1.0f));
     } else if (name == HdAovTokens->primId || name == HdAovTokens->instanceId
                || name == HdAovTokens->elementId) {
         return HdAovDescriptor(HdFormatInt32, false, VtValue(-1));
-    } else if (name == HdCyclesAovTokens->DiffDir) {
-        return HdAovDescriptor(colorFormat, false, VtValue(GfVec4f(0.0f)));
+    } else if (name == HdCyclesAovTokens->Vector) {
+        return HdAovDescriptor(HdFormatFloat32Vec4, false,
+                               VtValue(GfVec4f(0.0f)));
+    } else if (name == HdCyclesAovTokens->IndexMA) {
+        return HdAovDescriptor(HdFormatFloat32, false, VtValue(0.0f));
+    } else if (name == HdCyclesAovTokens->DiffDir
+               || name == HdCyclesAovTokens->GlossDir
+               || name == HdCyclesAovTokens->TransDir
+               || name == HdCyclesAovTokens->VolumeDir
+               || name == HdCyclesAovTokens->Emit
+               || name == HdCyclesAovTokens->Env
+               || name == HdCyclesAovTokens->AO
+               || name == HdCyclesAovTokens->Shadow) {
+        return HdAovDescriptor(HdFormatFloat32Vec3, false,
+                               VtValue(GfVec3f(0.0f)));
     }
 
     return HdAovDescriptor();
@@ -22,24 +22,37 @@
 #include "config.h"
 #include "renderBuffer.h"
 #include "renderDelegate.h"
+#include "sessionPool.h"
+#include "trace.h"
 #include "utils.h"
 
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+#include <map>
 #include <memory>
+#include <unordered_set>
 
 #include <device/device.h>
 #include <render/background.h>
 #include <render/buffers.h>
 #include <render/camera.h>
 #include <render/curves.h>
+#include <render/film.h>
 #include <render/hair.h>
 #include <render/integrator.h>
 #include <render/light.h>
 #include <render/mesh.h>
 #include <render/nodes.h>
 #include <render/object.h>
+#include <render/particles.h>
 #include <render/scene.h>
 #include <render/session.h>
+#include <render/shader.h>
 #include <render/stats.h>
+#include <util/util_string.h>
+
+#include <pxr/base/tf/staticTokens.h>
 
 #ifdef WITH_CYCLES_LOGGING
 #    include <util/util_logging.h>
@@ -51,6 +64,12 @@
 
 PXR_NAMESPACE_OPEN_SCOPE
 
+// clang-format off
+TF_DEFINE_PRIVATE_TOKENS(_tokens,
+    (dataWindowNDC)
+);
+// clang-format on
+
 double
 clamp(double d, double min, double max)
 {
@@ -67,32 +86,125 @@ struct HdCyclesDefaultAov {
     //int components;
 };
 
+// Format is the layout get_pass_rect writes, light passes are stored with
+// four components but read as rgb. Cycles has no instance index pass, so
+// instanceId isn't mapped.
+// clang-format off
 std::vector<HdCyclesDefaultAov> DefaultAovs = {
     { "Combined", ccl::PASS_COMBINED, HdAovTokens->color, HdFormatFloat32Vec4 },
-    //{ "Depth", ccl::PASS_DEPTH, HdAovTokens->depth, HdFormatFloat32 },
-    //{ "Normal", ccl::PASS_NORMAL, HdAovTokens->normal, HdFormatFloat32Vec4 },
-    //{ "DiffDir", ccl::PASS_DIFFUSE_DIRECT, HdCyclesAovTokens->DiffDir, HdFormatFloat32Vec4 },
-    //{ "IndexOB", ccl::PASS_OBJECT_ID, HdAovTokens->primId, HdFormatFloat32 },
-    //{ "Mist", ccl::PASS_MIST, HdAovTokens->depth, HdFormatFloat32 },
-
+    { "Depth", ccl::PASS_DEPTH, HdAovTokens->depth, HdFormatFloat32 },
+    { "Normal", ccl::PASS_NORMAL, HdAovTokens->normal, HdFormatFloat32Vec3 },
+    { "Vector", ccl::PASS_MOTION, HdCyclesAovTokens->Vector, HdFormatFloat32Vec4 },
+    { "IndexOB", ccl::PASS_OBJECT_ID, HdAovTokens->primId, HdFormatFloat32 },
+    { "IndexMA", ccl::PASS_MATERIAL_ID, HdCyclesAovTokens->IndexMA, HdFormatFloat32 },
+    { "DiffDir", ccl::PASS_DIFFUSE_DIRECT, HdCyclesAovTokens->DiffDir, HdFormatFloat32Vec3 },
+    { "GlossDir", ccl::PASS_GLOSSY_DIRECT, HdCyclesAovTokens->GlossDir, HdFormatFloat32Vec3 },
+    { "TransDir", ccl::PASS_TRANSMISSION_DIRECT, HdCyclesAovTokens->TransDir, HdFormatFloat32Vec3 },
+    { "VolumeDir", ccl::PASS_VOLUME_DIRECT, HdCyclesAovTokens->VolumeDir, HdFormatFloat32Vec3 },
+    { "Emit", ccl::PASS_EMISSION, HdCyclesAovTokens->Emit, HdFormatFloat32Vec3 },
+    { "Env", ccl::PASS_BACKGROUND, HdCyclesAovTokens->Env, HdFormatFloat32Vec3 },
+    { "AO", ccl::PASS_AO, HdCyclesAovTokens->AO, HdFormatFloat32Vec3 },
+    { "Shadow", ccl::PASS_SHADOW, HdCyclesAovTokens->Shadow, HdFormatFloat32Vec3 },
 };
+// clang-format on
+
+namespace {
+
+const HdCyclesDefaultAov*
+_FindDefaultAov(const TfToken& a_token)
+{
+    for (const HdCyclesDefaultAov& aov : DefaultAovs) {
+        if (aov.token == a_token)
+            return &aov;
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Read a pass of the given buffers in the layout of the AOV
+ * 
+ * @param a_pixels Sized for the buffers in the AOV format, zeroed if the pass
+ * isn't there
+ */
+void
+_ReadPass(ccl::RenderBuffers* a_buffers, const HdCyclesDefaultAov& a_aov,
+          float a_exposure, int a_sample, float* a_pixels)
+{
+    const int numComponents = HdGetComponentCount(a_aov.format);
+    const int numPixels     = a_buffers->params.width
+                              * a_buffers->params.height;
+    const size_t size       = static_cast<size_t>(numPixels) * numComponents;
+
+    if (!a_buffers->get_pass_rect(a_aov.name.c_str(), a_exposure, a_sample,
+                                  numComponents, a_pixels)) {
+        std::fill(a_pixels, a_pixels + size, 0.0f);
+        return;
+    }
+
+    // Objects are given their prim id + 1, the empty background reads as 0
+    // where Hydra expects -1
+    if (a_aov.type == ccl::PASS_OBJECT_ID) {
+        for (size_t i = 0; i < size; ++i)
+            a_pixels[i] -= 1.0f;
+    }
+}
+
+// Seconds per pixel of a progressive pass, measured by the sessions of every
+// render param. Cycles only reads the start resolution when a session is
+// created, so it is picked for the sessions created after a measurement.
+std::atomic<double> PixelPassCost(0.0);
+
+/**
+ * @brief Graph of the default background, a grey world if emissive
+ * 
+ */
+ccl::ShaderGraph*
+_CreateBackgroundGraph(bool a_emissive)
+{
+    ccl::ShaderGraph* graph = new ccl::ShaderGraph();
+    if (a_emissive) {
+        ccl::BackgroundNode* bgNode = new ccl::BackgroundNode();
+        bgNode->color               = ccl::make_float3(0.6f, 0.6f, 0.6f);
+
+        graph->add(bgNode);
+
+        ccl::ShaderNode* out = graph->output();
+        graph->connect(bgNode->output("Background"), out->input("Surface"));
+    }
+    return graph;
+}
+
+}  // namespace
 
 HdCyclesRenderParam::HdCyclesRenderParam()
     : m_shouldUpdate(false)
+    , m_cameraChanged(false)
     , m_renderPercent(0)
     , m_renderProgress(0.0f)
+    , m_displayVersion(1)
+    , m_totalTime(0.0)
+    , m_renderTime(0.0)
+    , m_renderStats()
+    , m_defaultBackground(nullptr)
+    , m_defaultBackgroundEmissive(false)
     , m_useSquareSamples(false)
+    , m_samplingPattern(ccl::SAMPLING_PATTERN_SOBOL)
     , m_useTiledRendering(false)
     , m_cyclesScene(nullptr)
     , m_cyclesSession(nullptr)
-    , m_objectsUpdated(false)
-    , m_geometryUpdated(false)
-    , m_curveUpdated(false)
-    , m_meshUpdated(false)
-    , m_lightsUpdated(false)
-    , m_shadersUpdated(false)
+    , m_sessionIsWarm(false)
+    , m_passBindings(std::make_shared<const PassBindings>())
+    , m_sequenceMode(false)
+    , m_overlapSync(false)
+    , m_displayBufferFloat(false)
+    , m_timeLimit(0.0)
+    , m_targetFrameTime(0.0)
+    , m_passDivider(0)
+    , m_dataWindowNDC(0.0f, 0.0f, 1.0f, 1.0f)
+    , m_pendingChanges(NoChanges)
 {
     _InitializeDefaults();
+    _ResetRenderStats();
 }
 
 void
@@ -104,6 +216,33 @@ HdCyclesRenderParam::_InitializeDefaults()
     m_deviceName                        = config.device_name.value;
     m_useSquareSamples                  = config.use_square_samples.value;
     m_useTiledRendering                 = config.use_tiled_rendering;
+    m_sequenceMode                      = config.sequence_mode.value;
+    m_overlapSync                       = config.overlap_sync.value;
+    m_displayBufferFloat                = config.display_buffer_float.value;
+    m_timeLimit = std::max(static_cast<double>(config.time_limit.value), 0.0);
+
+    // Tiles are rendered to completion one after the other, stopping early
+    // would leave part of the image unrendered
+    if (m_useTiledRendering && m_timeLimit > 0.0) {
+        TF_WARN("HD_CYCLES_TIME_LIMIT is ignored with tiled rendering");
+        m_timeLimit = 0.0;
+    }
+
+    // Cycles only denoises the tiles of sessions without their own buffers,
+    // tiles written to the AOVs by the tile callbacks aren't denoised
+    if (m_useTiledRendering && config.enable_denoising.value)
+        TF_WARN("HD_CYCLES_ENABLE_DENOISING is ignored with tiled rendering");
+
+    // Tiled renders have no low resolution passes
+    m_targetFrameTime = 0.0;
+    if (!m_useTiledRendering)
+        m_targetFrameTime = std::max(config.target_frame_time.value, 0.0f)
+                            / 1000.0;
+
+    m_interruptWindow  = std::chrono::milliseconds(
+        std::max(config.interrupt_window.value, 0));
+    m_interruptLatency = std::chrono::milliseconds(
+        std::max(config.interrupt_latency.value, 0));
 
     m_upAxis = UpAxis::Z;
     if (config.up_axis == "Z") {
@@ -129,16 +268,45 @@ HdCyclesRenderParam::GetProgress()
 bool
 HdCyclesRenderParam::IsConverged()
 {
+    // Keep the viewer polling until coalesced edits have been committed
+    {
+        std::lock_guard<std::mutex> lock(m_interruptMutex);
+        if (m_shouldUpdate || m_cameraChanged)
+            return false;
+    }
+
     return GetProgress() >= 1.0f;
 }
 
 void
 HdCyclesRenderParam::_SessionUpdateCallback()
 {
+    // Progress is reported before a sample is rendered and after it's copied
+    // to the display, so readers miss at most one sample
+    m_displayVersion++;
+
+    if (m_targetFrameTime > 0.0)
+        _MeasureProgressivePass();
+
     // - Get Session progress integer amount
 
     m_renderProgress = m_cyclesSession->progress.get_progress();
 
+    // A time limited render is done at the limit or the last sample,
+    // whichever comes first
+    if (m_timeLimit > 0.0) {
+        std::chrono::duration<double> sinceReset;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            sinceReset = std::chrono::steady_clock::now()
+                         - m_renderStats.resetTime;
+        }
+        m_renderProgress = std::max(
+            m_renderProgress,
+            static_cast<float>(std::min(sinceReset.count() / m_timeLimit,
+                                        1.0)));
+    }
+
     int newPercent = (int)(floor(m_renderProgress * 100));
     if (newPercent != m_renderPercent) {
         m_renderPercent = newPercent;
@@ -154,6 +322,8 @@ HdCyclesRenderParam::_SessionUpdateCallback()
 
     m_cyclesSession->progress.get_time(m_totalTime, m_renderTime);
 
+    _UpdateRenderStats();
+
     // - Handle Session status logging
 
     if (HdCyclesConfig::GetInstance().enable_logging) {
@@ -166,22 +336,221 @@ HdCyclesRenderParam::_SessionUpdateCallback()
     }
 }
 
+void
+HdCyclesRenderParam::_UpdateRenderStats()
+{
+    const float progress    = m_renderProgress;
+    const int currentSample = m_cyclesSession->progress.get_current_sample();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    RenderStats& stats = m_renderStats;
+
+    // Sizes of the last reset, the buffer params are written by the Hydra
+    // thread
+    const int totalSamples = stats.totalSamples;
+
+    // Progress is the fraction of pixel samples rendered, the count is
+    // estimated from it. Cycles doesn't report the rays it actually traced.
+    const uint64_t totalPixelSamples = stats.numPixels * totalSamples;
+    const uint64_t pixelSamples      = static_cast<uint64_t>(
+        static_cast<double>(progress) * totalPixelSamples);
+
+    // Tiles finish one after the other, the average over the image is the
+    // only meaningful sample count
+    int completedSamples = currentSample;
+    if (m_useTiledRendering)
+        completedSamples = static_cast<int>(progress * totalSamples);
+    completedSamples = std::min(std::max(completedSamples, 0), totalSamples);
+
+    stats.progress         = progress;
+    stats.completedSamples = completedSamples;
+    stats.pixelSamples     = pixelSamples;
+    stats.totalTime        = m_totalTime;
+    stats.pathTraceTime    = m_renderTime;
+
+    // Path tracing starts once the device is updated, the render time of
+    // the session excludes the scene update.
+    if (stats.deviceUpdateTime < 0.0 && pixelSamples > 0) {
+        std::chrono::duration<double> sinceReset
+            = std::chrono::steady_clock::now() - stats.resetTime;
+        stats.deviceUpdateTime = std::max(sinceReset.count() - m_renderTime,
+                                          0.0);
+    }
+
+    if (m_renderTime > 0.0) {
+        stats.samplesPerSecond      = completedSamples / m_renderTime;
+        stats.pixelSamplesPerSecond = pixelSamples / m_renderTime;
+    }
+
+    // Estimated from the average pixel sample rate so far
+    stats.eta = 0.0;
+    if (stats.pixelSamplesPerSecond > 0.0 && pixelSamples < totalPixelSamples)
+        stats.eta = (totalPixelSamples - pixelSamples)
+                    / stats.pixelSamplesPerSecond;
+}
+
+void
+HdCyclesRenderParam::_UpdateMemoryStats()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        if (!m_renderStats.memoryStale)
+            return;
+    }
+
+    // Never wait on the session while it updates the device
+    if (!m_cyclesScene->mutex.try_lock())
+        return;
+
+    // Collecting before the device update dereferences unloaded images
+    if (m_cyclesScene->need_update()) {
+        m_cyclesScene->mutex.unlock();
+        return;
+    }
+
+    ccl::RenderStats renderStats;
+    m_cyclesScene->collect_statistics(&renderStats);
+
+    const size_t numObjects = m_cyclesScene->objects.size();
+    const size_t numShaders = m_cyclesScene->shaders.size();
+    const size_t numLights  = m_cyclesScene->lights.size();
+
+    m_cyclesScene->mutex.unlock();
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    RenderStats& stats     = m_renderStats;
+    stats.geometryMemory   = renderStats.mesh.geometry.total_size;
+    stats.textureMemory    = renderStats.image.textures.total_size;
+    stats.deviceMemory     = m_cyclesSession->device->stats.mem_used;
+    stats.deviceMemoryPeak = m_cyclesSession->device->stats.mem_peak;
+    stats.numObjects       = numObjects;
+    stats.numShaders       = numShaders;
+    stats.numLights        = numLights;
+    stats.memoryStale      = false;
+}
+
+void
+HdCyclesRenderParam::_ResetRenderStats()
+{
+    m_renderProgress = 0.0f;
+
+    std::lock_guard<std::mutex> lock(m_statsMutex);
+
+    // The session renders the buffers and samples of this reset
+    RenderStats& stats = m_renderStats;
+    stats.numPixels    = static_cast<uint64_t>(m_bufferParams.width)
+                         * m_bufferParams.height;
+    stats.totalSamples = _GetSessionParams()->samples;
+
+    stats.progress              = 0.0f;
+    stats.completedSamples      = 0;
+    stats.pixelSamples          = 0;
+    stats.samplesPerSecond      = 0.0;
+    stats.pixelSamplesPerSecond = 0.0;
+    stats.eta                   = 0.0;
+    stats.deviceUpdateTime      = -1.0;
+    stats.pathTraceTime         = 0.0;
+    stats.memoryStale           = true;
+    stats.completedTiles        = 0;
+    stats.resetTime             = std::chrono::steady_clock::now();
+}
+
+void
+HdCyclesRenderParam::_MeasureProgressivePass()
+{
+    const ccl::TileManager& tileManager = m_cyclesSession->tile_manager;
+
+    const int divider = tileManager.state.resolution_divider;
+    if (divider == m_passDivider)
+        return;
+
+    // A finished pass halves the divider, a reset raises it again and its
+    // first pass would include the scene update
+    const auto now = std::chrono::steady_clock::now();
+    if (divider < m_passDivider) {
+        const std::chrono::duration<double> passTime = now - m_passStartTime;
+        const double passPixels = static_cast<double>(tileManager.params.width)
+                                  * tileManager.params.height
+                                  / (m_passDivider * m_passDivider);
+        const double cost = passTime.count() / std::max(passPixels, 1.0);
+
+        // Smoothed, a single slow pass shouldn't drop the resolution
+        const double previous = PixelPassCost.load();
+        PixelPassCost.store(previous > 0.0 ? (previous + cost) * 0.5 : cost);
+    }
+
+    m_passDivider   = divider;
+    m_passStartTime = now;
+}
+
+void
+HdCyclesRenderParam::_UpdateStartResolution()
+{
+    if (m_targetFrameTime <= 0.0)
+        return;
+
+    // The configured start resolution is used until a pass was timed
+    const double cost = PixelPassCost.load();
+    if (cost <= 0.0)
+        return;
+
+    // Smallest power of two divider whose pass fits the target, for the
+    // size the scene is created with
+    static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
+    const double pixels = static_cast<double>(config.render_width.value)
+                          * config.render_height.value;
+    const int maxDivider = 64;
+    int divider          = 1;
+    while (divider < maxDivider
+           && cost * pixels / (divider * divider) > m_targetFrameTime) {
+        divider <<= 1;
+    }
+
+    // The tile manager divides the image until it is start_resolution
+    // pixels across, a divider of 1 starts at full resolution
+    m_sessionParams.start_resolution = std::max(
+        static_cast<int>(std::ceil(std::sqrt(pixels) / divider)), 1);
+}
+
 /*
-    This paradigm does cause unecessary loops through settingsMap for each feature. 
-    This should be addressed in the future. For the moment, the flexibility of setting
-    order of operations is more important.
+    The settings map is walked once and bucketed by category, each bucket is
+    then applied in the order the Cycles objects get created.
 */
 bool
 HdCyclesRenderParam::Initialize(HdRenderSettingsMap const& settingsMap)
 {
+    using SettingEntry = std::pair<const HdRenderSettingsMap::value_type*,
+                                   const RenderSetting*>;
+
+    std::vector<SettingEntry> settingsByCategory[SettingCategoryCount];
+
+    const RenderSettingRegistry& registry = _GetRenderSettingRegistry();
+    for (auto& entry : settingsMap) {
+        auto it = registry.find(entry.first);
+        if (it != registry.end()) {
+            settingsByCategory[it->second.category].emplace_back(&entry,
+                                                                 &it->second);
+        }
+    }
+
+    auto applySettings = [this,
+                          &settingsByCategory](SettingCategory a_category) {
+        for (const SettingEntry& setting : settingsByCategory[a_category]) {
+            _ApplyRenderSetting(setting.first->first, *setting.second,
+                                setting.first->second);
+        }
+    };
+
     // -- Delegate
     _UpdateDelegateFromConfig(true);
-    _UpdateDelegateFromRenderSettings(settingsMap);
+    applySettings(SettingDelegate);
     _UpdateDelegateFromConfig();
 
     // -- Session
     _UpdateSessionFromConfig(true);
-    _UpdateSessionFromRenderSettings(settingsMap);
+    applySettings(SettingSession);
     _UpdateSessionFromConfig();
 
     if (!_CreateSession()) {
@@ -192,7 +561,7 @@ HdCyclesRenderParam::Initialize(HdRenderSettingsMap const& settingsMap)
 
     // -- Scene
     _UpdateSceneFromConfig(true);
-    _UpdateSceneFromRenderSettings(settingsMap);
+    applySettings(SettingScene);
     _UpdateSceneFromConfig();
 
     if (!_CreateScene()) {
@@ -203,21 +572,24 @@ HdCyclesRenderParam::Initialize(HdRenderSettingsMap const& settingsMap)
 
     // -- Film
     _UpdateFilmFromConfig(true);
-    _UpdateFilmFromRenderSettings(settingsMap);
+    applySettings(SettingFilm);
     _UpdateFilmFromConfig();
 
     // -- Integrator
     _UpdateIntegratorFromConfig(true);
-    _UpdateIntegratorFromRenderSettings(settingsMap);
+    applySettings(SettingIntegrator);
     _UpdateIntegratorFromConfig();
 
     // -- Background
     _UpdateBackgroundFromConfig(true);
-    _UpdateBackgroundFromRenderSettings(settingsMap);
+    applySettings(SettingBackground);
     _UpdateBackgroundFromConfig();
 
     _HandlePasses();
 
+    // A new session isn't started yet and a kept one was paused on release
+    _ApplyDenoising();
+
     return true;
 }
 
@@ -235,42 +607,6 @@ HdCyclesRenderParam::_UpdateDelegateFromConfig(bool a_forceInit)
         sessionParams = &m_cyclesSession->params;
 }
 
-void
-HdCyclesRenderParam::_UpdateDelegateFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
-{
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
-        _HandleDelegateRenderSetting(key, value);
-    }
-}
-
-bool
-HdCyclesRenderParam::_HandleDelegateRenderSetting(const TfToken& key,
-                                                  const VtValue& value)
-{
-#ifdef USE_USD_CYCLES_SCHEMA
-
-    bool delegate_updated = false;
-
-    if (key == usdCyclesTokens->cyclesUse_square_samples) {
-        m_useSquareSamples = _HdCyclesGetVtValue<bool>(value,
-                                                       m_useSquareSamples,
-                                                       &delegate_updated);
-    }
-
-    if (delegate_updated) {
-        // Although this is called, it does not correctly reset session in IPR
-        //Interrupt();
-        return true;
-    }
-
-#endif
-
-    return false;
-}
-
 // -- Session
 
 void
@@ -316,183 +652,23 @@ HdCyclesRenderParam::_UpdateSessionFromConfig(bool a_forceInit)
     }
 
     config.max_samples.eval(sessionParams->samples, a_forceInit);
-}
-
-void
-HdCyclesRenderParam::_UpdateSessionFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
-{
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
-        _HandleSessionRenderSetting(key, value);
-    }
-}
-
-bool
-HdCyclesRenderParam::_HandleSessionRenderSetting(const TfToken& key,
-                                                 const VtValue& value)
-{
-#ifdef USE_USD_CYCLES_SCHEMA
-
-    ccl::SessionParams* sessionParams = &m_sessionParams;
-
-    if (m_cyclesSession)
-        sessionParams = &m_cyclesSession->params;
-
-    bool session_updated = false;
-
-    // This is now handled by HdCycles depending on tiled or not tiled rendering...
-    /*if (key == usdCyclesTokens->cyclesBackground) {
-        sessionParams->background
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->background,
-                                        &session_updated);
-    }*/
-
-    if (key == usdCyclesTokens->cyclesProgressive_refine) {
-        sessionParams->progressive_refine = _HdCyclesGetVtValue<bool>(
-            value, sessionParams->progressive_refine, &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesProgressive) {
-        sessionParams->progressive
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->progressive,
-                                        &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesProgressive_update_timeout) {
-        sessionParams->progressive_update_timeout = _HdCyclesGetVtValue<float>(
-            value, sessionParams->progressive_update_timeout, &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesExperimental) {
-        sessionParams->experimental
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->experimental,
-                                        &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesSamples) {
-        sessionParams->samples
-            = _HdCyclesGetVtValue<int>(value, sessionParams->samples,
-                                       &session_updated);
-    }
-
-    // Tiles
-
-    if (key == usdCyclesTokens->cyclesTile_size) {
-        sessionParams->tile_size = vec2i_to_int2(_HdCyclesGetVtValue<GfVec2i>(
-            value, int2_to_vec2i(sessionParams->tile_size), &session_updated));
-    }
-
-    TfToken tileOrder;
-    if (key == usdCyclesTokens->cyclesTile_order) {
-        tileOrder = _HdCyclesGetVtValue<TfToken>(value, tileOrder,
-                                                 &session_updated);
-
-        if (tileOrder == usdCyclesTokens->hilbert_spiral) {
-            sessionParams->tile_order = ccl::TILE_HILBERT_SPIRAL;
-        } else if (tileOrder == usdCyclesTokens->center) {
-            sessionParams->tile_order = ccl::TILE_CENTER;
-        } else if (tileOrder == usdCyclesTokens->right_to_left) {
-            sessionParams->tile_order = ccl::TILE_RIGHT_TO_LEFT;
-        } else if (tileOrder == usdCyclesTokens->left_to_right) {
-            sessionParams->tile_order = ccl::TILE_LEFT_TO_RIGHT;
-        } else if (tileOrder == usdCyclesTokens->top_to_bottom) {
-            sessionParams->tile_order = ccl::TILE_TOP_TO_BOTTOM;
-        } else if (tileOrder == usdCyclesTokens->bottom_to_top) {
-            sessionParams->tile_order = ccl::TILE_BOTTOM_TO_TOP;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesStart_resolution) {
-        sessionParams->start_resolution
-            = _HdCyclesGetVtValue<int>(value, sessionParams->start_resolution,
-                                       &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesPixel_size) {
-        sessionParams->pixel_size
-            = _HdCyclesGetVtValue<int>(value, sessionParams->pixel_size,
-                                       &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesThreads) {
-        sessionParams->threads
-            = _HdCyclesGetVtValue<int>(value, sessionParams->threads,
-                                       &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesAdaptive_sampling) {
-        sessionParams->adaptive_sampling
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->adaptive_sampling,
-                                        &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesUse_profiling) {
-        sessionParams->use_profiling
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->use_profiling,
-                                        &session_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesDisplay_buffer_linear) {
-        sessionParams->display_buffer_linear = _HdCyclesGetVtValue<bool>(
-            value, sessionParams->display_buffer_linear, &session_updated);
-    }
-
-    //DenoiseParams denoising;
-
-    TfToken shadingSystem;
-    if (key == usdCyclesTokens->cyclesShading_system) {
-        shadingSystem = _HdCyclesGetVtValue<TfToken>(value, shadingSystem,
-                                                     &session_updated);
-
-        if (shadingSystem == usdCyclesTokens->osl) {
-            sessionParams->shadingsystem = ccl::SHADINGSYSTEM_OSL;
-        } else {
-            sessionParams->shadingsystem = ccl::SHADINGSYSTEM_SVM;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesUse_profiling) {
-        sessionParams->use_profiling
-            = _HdCyclesGetVtValue<bool>(value, sessionParams->use_profiling,
-                                        &session_updated);
-    }
-
-    // Session BVH
-
-
-    // Denoising
-
-    bool denoising_updated = false;
-    ccl::DenoiseParams denoisingParams;
-
-    if (key == usdCyclesTokens->cyclesRun_denoising) {
-        denoisingParams.use = _HdCyclesGetVtValue<int>(value,
-                                                       denoisingParams.use,
-                                                       &denoising_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesDenoising_start_sample) {
-        sessionParams->denoising_start_sample = _HdCyclesGetVtValue<int>(
-            value, sessionParams->denoising_start_sample, &denoising_updated);
-    }
-
-    if (denoising_updated) {
-        sessionParams->denoising = denoisingParams;
-        session_updated          = true;
-    }
-
-    // Final
-
-    if (session_updated) {
-        // Although this is called, it does not correctly reset session in IPR
-        //Interrupt();
-        return true;
-    }
 
-#endif
-    return false;
+    // The session stops sampling by itself once the limit is reached, even
+    // if the host stopped syncing after IsConverged
+    sessionParams->time_limit = m_timeLimit;
+    config.adaptive_sampling.eval(sessionParams->adaptive_sampling,
+                                  a_forceInit);
+
+    // The CPU denoiser, run by the session at intervals while the viewport
+    // samples. Tiled renders are never denoised.
+    config.enable_denoising.eval(sessionParams->denoising.use, a_forceInit);
+    if (m_useTiledRendering)
+        sessionParams->denoising.use = false;
+    config.denoising_start_sample.eval(sessionParams->denoising_start_sample,
+                                       a_forceInit);
+    sessionParams->denoising.type = ccl::DENOISER_OPENIMAGEDENOISE;
+    sessionParams->denoising.input_passes
+        = ccl::DENOISER_INPUT_RGB_ALBEDO_NORMAL;
 }
 
 // -- Scene
@@ -524,94 +700,6 @@ HdCyclesRenderParam::_UpdateSceneFromConfig(bool a_forceInit)
     config.curve_subdivisions.eval(sceneParams->hair_subdivisions, a_forceInit);
 }
 
-void
-HdCyclesRenderParam::_UpdateSceneFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
-{
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
-        _HandleSceneRenderSetting(key, value);
-    }
-}
-
-bool
-HdCyclesRenderParam::_HandleSceneRenderSetting(const TfToken& key,
-                                               const VtValue& value)
-{
-#ifdef USE_USD_CYCLES_SCHEMA
-    // -- Scene
-
-    ccl::SceneParams* sceneParams = &m_sceneParams;
-
-    if (m_cyclesScene)
-        sceneParams = &m_cyclesScene->params;
-
-    bool scene_updated = false;
-
-    if (key == usdCyclesTokens->cyclesShading_system) {
-        TfToken shading_system
-            = _HdCyclesGetVtValue<TfToken>(value, usdCyclesTokens->svm,
-                                           &scene_updated);
-        if (shading_system == usdCyclesTokens->svm) {
-            sceneParams->shadingsystem = ccl::SHADINGSYSTEM_SVM;
-        } else if (shading_system == usdCyclesTokens->osl) {
-            sceneParams->shadingsystem = ccl::SHADINGSYSTEM_OSL;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesBvh_type) {
-        TfToken bvh_type
-            = _HdCyclesGetVtValue<TfToken>(value, usdCyclesTokens->bvh_dynamic,
-                                           &scene_updated);
-        if (bvh_type == usdCyclesTokens->bvh_dynamic) {
-            sceneParams->bvh_type = ccl::SceneParams::BVH_DYNAMIC;
-        } else if (bvh_type == usdCyclesTokens->bvh_static) {
-            sceneParams->bvh_type = ccl::SceneParams::BVH_STATIC;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesCurve_subdivisions) {
-        sceneParams->hair_subdivisions
-            = _HdCyclesGetVtValue<int>(value, sceneParams->hair_subdivisions,
-                                       &scene_updated);
-    }
-
-    // TODO: Unsure how we will handle this if the camera hasn't been created yet/at all...
-    /*if (key == usdCyclesTokens->cyclesDicing_camera) {
-        scene->dicing_camera
-            = _HdCyclesGetVtValue<std::string>(value, scene->dicing_camera,
-                                       &scene_updated);
-    }*/
-
-
-    if (key == usdCyclesTokens->cyclesUse_bvh_spatial_split) {
-        sceneParams->use_bvh_spatial_split = _HdCyclesGetVtValue<bool>(
-            value, sceneParams->use_bvh_spatial_split, &scene_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesUse_bvh_unaligned_nodes) {
-        sceneParams->use_bvh_unaligned_nodes = _HdCyclesGetVtValue<bool>(
-            value, sceneParams->use_bvh_unaligned_nodes, &scene_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesNum_bvh_time_steps) {
-        sceneParams->num_bvh_time_steps
-            = _HdCyclesGetVtValue<int>(value, sceneParams->num_bvh_time_steps,
-                                       &scene_updated);
-    }
-
-    if (scene_updated) {
-        // Although this is called, it does not correctly reset session in IPR
-        if (m_cyclesSession && m_cyclesScene)
-            Interrupt(true);
-        return true;
-    }
-
-#endif
-    return false;
-}
-
 // -- Config
 
 void
@@ -670,729 +758,1034 @@ HdCyclesRenderParam::_UpdateIntegratorFromConfig(bool a_forceInit)
         integrator->volume_samples = integrator->volume_samples
                                      * integrator->volume_samples;
     }
-    /*if (config.adaptive_min_samples.eval(integrator->adaptive_min_samples)
+    if (config.adaptive_min_samples.eval(integrator->adaptive_min_samples,
+                                         a_forceInit)
         && m_useSquareSamples) {
-        integrator->adaptive_min_samples
-            = std::min(integrator->adaptive_min_samples
-                           * integrator->adaptive_min_samples,
-                       INT_MAX);
-    }*/
+        integrator->adaptive_min_samples = integrator->adaptive_min_samples
+                                           * integrator->adaptive_min_samples;
+    }
+    config.adaptive_threshold.eval(integrator->adaptive_threshold,
+                                   a_forceInit);
 
     config.enable_motion_blur.eval(integrator->motion_blur, a_forceInit);
 
     integrator->tag_update(m_cyclesScene);
 }
 
+// -- Film
+
 void
-HdCyclesRenderParam::_UpdateIntegratorFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
+HdCyclesRenderParam::_UpdateFilmFromConfig(bool a_forceInit)
 {
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
+    if (!m_cyclesScene)
+        return;
 
-        _HandleIntegratorRenderSetting(key, value);
-    }
-}
+    static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
 
-bool
-HdCyclesRenderParam::_HandleIntegratorRenderSetting(const TfToken& key,
-                                                    const VtValue& value)
-{
-#ifdef USE_USD_CYCLES_SCHEMA
+    ccl::Film* film = m_cyclesScene->film;
 
-    // -- Integrator Settings
+    config.exposure.eval(film->exposure, a_forceInit);
 
-    ccl::Integrator* integrator = m_cyclesScene->integrator;
-    bool integrator_updated     = false;
+    film->tag_update(m_cyclesScene);
+}
 
-    if (key == usdCyclesTokens->cyclesIntegratorSeed) {
-        integrator->seed = _HdCyclesGetVtValue<int>(value, integrator->seed,
-                                                    &integrator_updated);
-    }
+void
+HdCyclesRenderParam::_UpdateBackgroundFromConfig(bool a_forceInit)
+{
+    if (!m_cyclesScene)
+        return;
 
-    if (key == usdCyclesTokens->cyclesIntegratorMin_bounce) {
-        integrator->min_bounce
-            = _HdCyclesGetVtValue<int>(value, integrator->min_bounce,
-                                       &integrator_updated);
-    }
+    static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
 
-    if (key == usdCyclesTokens->cyclesIntegratorMax_bounce) {
-        integrator->max_bounce
-            = _HdCyclesGetVtValue<int>(value, integrator->max_bounce,
-                                       &integrator_updated);
-    }
+    ccl::Background* background = m_cyclesScene->background;
 
-    if (key == usdCyclesTokens->cyclesIntegratorMethod) {
-        TfToken integratorMethod
-            = _HdCyclesGetVtValue<TfToken>(value, usdCyclesTokens->path,
-                                           &integrator_updated);
-        if (integratorMethod == usdCyclesTokens->path) {
-            integrator->method = ccl::Integrator::PATH;
-        } else {
-            integrator->method = ccl::Integrator::BRANCHED_PATH;
-        }
-    }
+    if (config.enable_transparent_background.value)
+        background->transparent = true;
 
-    if (key == usdCyclesTokens->cyclesIntegratorSampling_method) {
-        TfToken samplingMethod
-            = _HdCyclesGetVtValue<TfToken>(value, usdCyclesTokens->sobol,
-                                           &integrator_updated);
-        if (samplingMethod == usdCyclesTokens->sobol) {
-            integrator->sampling_pattern = ccl::SAMPLING_PATTERN_SOBOL;
-        } else if (samplingMethod == usdCyclesTokens->cmj) {
-            integrator->sampling_pattern = ccl::SAMPLING_PATTERN_CMJ;
-        } else {
-            integrator->sampling_pattern = ccl::SAMPLING_PATTERN_PMJ;
-        }
-    }
 
-    if (key == usdCyclesTokens->cyclesIntegratorMax_diffuse_bounce) {
-        integrator->max_diffuse_bounce
-            = _HdCyclesGetVtValue<int>(value, integrator->max_diffuse_bounce,
-                                       &integrator_updated);
-    }
+    background->tag_update(m_cyclesScene);
+}
 
-    if (key == usdCyclesTokens->cyclesIntegratorMax_glossy_bounce) {
-        integrator->max_glossy_bounce
-            = _HdCyclesGetVtValue<int>(value, integrator->max_glossy_bounce,
-                                       &integrator_updated);
-    }
-    if (key == usdCyclesTokens->cyclesIntegratorMax_transmission_bounce) {
-        integrator->max_transmission_bounce = _HdCyclesGetVtValue<int>(
-            value, integrator->max_transmission_bounce, &integrator_updated);
-    }
+void
+HdCyclesRenderParam::_HandlePasses()
+{
+    m_bufferParams.passes.clear();
 
-    if (key == usdCyclesTokens->cyclesIntegratorMax_volume_bounce) {
-        integrator->max_volume_bounce
-            = _HdCyclesGetVtValue<int>(value, integrator->max_volume_bounce,
-                                       &integrator_updated);
-    }
-    if (key == usdCyclesTokens->cyclesIntegratorTransparent_min_bounce) {
-        integrator->transparent_min_bounce = _HdCyclesGetVtValue<int>(
-            value, integrator->transparent_min_bounce, &integrator_updated);
-    }
+    // The display and the color AOV come from the combined pass
+    ccl::Pass::add(ccl::PASS_COMBINED, m_bufferParams.passes, "Combined");
 
-    if (key == usdCyclesTokens->cyclesIntegratorTransparent_max_bounce) {
-        integrator->transparent_max_bounce = _HdCyclesGetVtValue<int>(
-            value, integrator->transparent_max_bounce, &integrator_updated);
+    // Only the passes of bound AOVs are allocated and written by the kernels.
+    // Cycles adds the color passes light passes are divided by.
+    for (const HdRenderPassAovBinding& binding : m_aovs) {
+        if (const HdCyclesDefaultAov* aov = _FindDefaultAov(binding.aovName)) {
+            ccl::Pass::add(aov->type, m_bufferParams.passes, aov->name.c_str());
+        }
     }
 
-    if (key == usdCyclesTokens->cyclesIntegratorAo_bounces) {
-        integrator->ao_bounces
-            = _HdCyclesGetVtValue<int>(value, integrator->ao_bounces,
-                                       &integrator_updated);
+    // Adaptive sampling only works with the PMJ pattern, and keeps its
+    // per pixel error estimate and sample count in dedicated passes. The
+    // pattern of the render settings comes back once it is turned off.
+    const bool adaptiveSampling = _GetSessionParams()->adaptive_sampling;
+    if (adaptiveSampling) {
+        ccl::Pass::add(ccl::PASS_ADAPTIVE_AUX_BUFFER, m_bufferParams.passes);
+        ccl::Pass::add(ccl::PASS_SAMPLE_COUNT, m_bufferParams.passes);
     }
+    m_cyclesScene->film->use_adaptive_sampling = adaptiveSampling;
 
-    if (key == usdCyclesTokens->cyclesIntegratorVolume_max_steps) {
-        integrator->volume_max_steps
-            = _HdCyclesGetVtValue<int>(value, integrator->volume_max_steps,
-                                       &integrator_updated);
+    const ccl::SamplingPattern samplingPattern = adaptiveSampling
+                                                     ? ccl::SAMPLING_PATTERN_PMJ
+                                                     : m_samplingPattern;
+    ccl::Integrator* integrator = m_cyclesScene->integrator;
+    if (integrator->sampling_pattern != samplingPattern) {
+        integrator->sampling_pattern = samplingPattern;
+        integrator->tag_update(m_cyclesScene);
     }
 
-    if (key == usdCyclesTokens->cyclesIntegratorVolume_step_size) {
-        integrator->volume_step_rate
-            = _HdCyclesGetVtValue<float>(value, integrator->volume_step_rate,
-                                         &integrator_updated);
+    // The denoiser reads the albedo and normal features from the denoising
+    // data pass, which the kernels only write if the film asks for it
+    ccl::SessionParams* sessionParams = _GetSessionParams();
+    ccl::DenoiseParams& denoising     = sessionParams->denoising;
+    if (denoising.use && !(sessionParams->device.denoisers & denoising.type)) {
+        TF_WARN("Denoising is not supported by the %s device",
+                sessionParams->device.description.c_str());
+        denoising.use = false;
     }
 
-    if (key == usdCyclesTokens->cyclesIntegratorAdaptive_threshold) {
-        integrator->adaptive_threshold
-            = _HdCyclesGetVtValue<float>(value, integrator->adaptive_threshold,
-                                         &integrator_updated);
+    ccl::Film* film = m_cyclesScene->film;
+    if (film->denoising_data_pass != denoising.use) {
+        film->denoising_data_pass = denoising.use;
+        film->tag_update(m_cyclesScene);
     }
+    m_bufferParams.denoising_data_pass        = denoising.use;
+    m_bufferParams.denoising_clean_pass       = false;
+    m_bufferParams.denoising_prefiltered_pass = false;
 
-    // Samples
+    m_cyclesScene->film->tag_passes_update(m_cyclesScene,
+                                           m_bufferParams.passes);
+}
 
-    if (key == usdCyclesTokens->cyclesIntegratorAa_samples) {
-        bool sample_updated = false;
-        integrator->aa_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->aa_samples,
-                                       &sample_updated);
+void
+HdCyclesRenderParam::_ApplyDenoising()
+{
+    if (!m_cyclesSession)
+        return;
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->aa_samples = integrator->aa_samples
-                                         * integrator->aa_samples;
-            }
-            integrator_updated = true;
-        }
-    }
+    m_sessionDenoising = m_cyclesSession->params.denoising;
+    m_cyclesSession->set_denoising(m_sessionDenoising);
+}
 
-    if (key == usdCyclesTokens->cyclesIntegratorAdaptive_min_samples) {
-        bool sample_updated = false;
-        integrator->adaptive_min_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->adaptive_min_samples,
-                                       &sample_updated);
+void
+HdCyclesRenderParam::_UpdateDenoising()
+{
+    if (!m_cyclesSession)
+        return;
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->adaptive_min_samples
-                    = std::min(integrator->adaptive_min_samples
-                                   * integrator->adaptive_min_samples,
-                               INT_MAX);
-            }
-            integrator_updated = true;
-        }
+    const ccl::DenoiseParams& denoising = m_cyclesSession->params.denoising;
+    if (denoising.use == m_sessionDenoising.use
+        && denoising.type == m_sessionDenoising.type
+        && denoising.input_passes == m_sessionDenoising.input_passes
+        && denoising.store_passes == m_sessionDenoising.store_passes) {
+        return;
     }
 
-    if (key == usdCyclesTokens->cyclesIntegratorDiffuse_samples) {
-        bool sample_updated = false;
-        integrator->diffuse_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->diffuse_samples,
-                                       &sample_updated);
+    PauseRender();
+    _ApplyDenoising();
+    Interrupt();
+}
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->diffuse_samples = integrator->diffuse_samples
-                                              * integrator->diffuse_samples;
-            }
-            integrator_updated = true;
-        }
-    }
+// -- Render setting registry
 
-    if (key == usdCyclesTokens->cyclesIntegratorGlossy_samples) {
-        bool sample_updated = false;
-        integrator->glossy_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->glossy_samples,
-                                       &sample_updated);
+ccl::SessionParams*
+HdCyclesRenderParam::_GetSessionParams()
+{
+    if (m_cyclesSession)
+        return &m_cyclesSession->params;
+    return &m_sessionParams;
+}
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->glossy_samples = integrator->glossy_samples
-                                             * integrator->glossy_samples;
-            }
-            integrator_updated = true;
-        }
-    }
+ccl::SceneParams*
+HdCyclesRenderParam::_GetSceneParams()
+{
+    if (m_cyclesScene)
+        return &m_cyclesScene->params;
+    return &m_sceneParams;
+}
 
-    if (key == usdCyclesTokens->cyclesIntegratorTransmission_samples) {
-        bool sample_updated = false;
-        integrator->transmission_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->transmission_samples,
-                                       &sample_updated);
+const HdCyclesRenderParam::RenderSettingRegistry&
+HdCyclesRenderParam::_GetRenderSettingRegistry()
+{
+    static const RenderSettingRegistry registry = []() {
+        RenderSettingRegistry r;
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->transmission_samples
-                    = integrator->transmission_samples
-                      * integrator->transmission_samples;
-            }
-            integrator_updated = true;
-        }
-    }
+#ifdef USE_USD_CYCLES_SCHEMA
+        // Targets of each category
+        auto session = [](HdCyclesRenderParam& p) {
+            return p._GetSessionParams();
+        };
+        auto scene = [](HdCyclesRenderParam& p) {
+            return p._GetSceneParams();
+        };
+        auto integrator = [](HdCyclesRenderParam& p) {
+            return p.m_cyclesScene->integrator;
+        };
+        auto film = [](HdCyclesRenderParam& p) {
+            return p.m_cyclesScene->film;
+        };
+        auto background = [](HdCyclesRenderParam& p) {
+            return p.m_cyclesScene->background;
+        };
+
+        // Setting stored as is in a member of the target
+        auto member = [](SettingCategory a_category, auto a_target,
+                         auto a_member) {
+            return RenderSetting {
+                a_category, [a_target, a_member](HdCyclesRenderParam& p,
+                                                 const VtValue& value) {
+                    auto* target = a_target(p);
+                    using T = std::decay_t<decltype(target->*a_member)>;
+
+                    bool updated       = false;
+                    target->*a_member = _HdCyclesGetVtValue<T>(
+                        value, target->*a_member, &updated);
+                    return updated;
+                }
+            };
+        };
+
+        // Sample count, squared if the delegate uses square samples
+        auto samples = [](auto a_member) {
+            return RenderSetting {
+                SettingIntegrator,
+                [a_member](HdCyclesRenderParam& p, const VtValue& value) {
+                    ccl::Integrator* integrator = p.m_cyclesScene->integrator;
+
+                    bool updated = false;
+                    int samples  = _HdCyclesGetVtValue<int>(
+                        value, integrator->*a_member, &updated);
+                    if (updated) {
+                        integrator->*a_member = p.m_useSquareSamples
+                                                    ? samples * samples
+                                                    : samples;
+                    }
+                    return updated;
+                }
+            };
+        };
+
+        // Background ray visibility flag
+        auto visibility = [](uint a_flag) {
+            return RenderSetting {
+                SettingBackground,
+                [a_flag](HdCyclesRenderParam& p, const VtValue& value) {
+                    ccl::Background* background = p.m_cyclesScene->background;
+
+                    bool updated = false;
+                    bool visible = _HdCyclesGetVtValue<bool>(
+                        value, background->visibility & a_flag, &updated);
+                    if (visible)
+                        background->visibility |= a_flag;
+                    else
+                        background->visibility &= ~a_flag;
+                    return updated;
+                }
+            };
+        };
 
-    if (key == usdCyclesTokens->cyclesIntegratorAo_samples) {
-        bool sample_updated = false;
-        integrator->ao_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->ao_samples,
-                                       &sample_updated);
+        // -- Delegate
 
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->ao_samples = integrator->ao_samples
-                                         * integrator->ao_samples;
+        r[usdCyclesTokens->cyclesUse_square_samples] = {
+            SettingDelegate, [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated         = false;
+                p.m_useSquareSamples = _HdCyclesGetVtValue<bool>(
+                    value, p.m_useSquareSamples, &updated);
+                return updated;
             }
-            integrator_updated = true;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesIntegratorMesh_light_samples) {
-        bool sample_updated = false;
-        integrator->mesh_light_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->mesh_light_samples,
-                                       &sample_updated);
-
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->mesh_light_samples
-                    = integrator->mesh_light_samples
-                      * integrator->mesh_light_samples;
+        };
+
+        // -- Session
+
+        // Background is handled by HdCycles depending on tiled or not tiled
+        // rendering, so cyclesBackground is not registered.
+
+        r[usdCyclesTokens->cyclesProgressive_refine]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::progressive_refine);
+        r[usdCyclesTokens->cyclesProgressive]
+            = member(SettingSession, session, &ccl::SessionParams::progressive);
+        r[usdCyclesTokens->cyclesProgressive_update_timeout] = {
+            SettingSession, [](HdCyclesRenderParam& p, const VtValue& value) {
+                ccl::SessionParams* params = p._GetSessionParams();
+
+                bool updated = false;
+                params->progressive_update_timeout = _HdCyclesGetVtValue<float>(
+                    value, params->progressive_update_timeout, &updated);
+                return updated;
             }
-            integrator_updated = true;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesIntegratorSubsurface_samples) {
-        bool sample_updated = false;
-        integrator->subsurface_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->subsurface_samples,
-                                       &sample_updated);
-
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->subsurface_samples
-                    = integrator->subsurface_samples
-                      * integrator->subsurface_samples;
+        };
+        r[usdCyclesTokens->cyclesExperimental]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::experimental);
+        r[usdCyclesTokens->cyclesSamples]
+            = member(SettingSession, session, &ccl::SessionParams::samples);
+
+        r[usdCyclesTokens->cyclesTile_size] = {
+            SettingSession, [](HdCyclesRenderParam& p, const VtValue& value) {
+                ccl::SessionParams* params = p._GetSessionParams();
+
+                bool updated      = false;
+                params->tile_size = vec2i_to_int2(_HdCyclesGetVtValue<GfVec2i>(
+                    value, int2_to_vec2i(params->tile_size), &updated));
+                return updated;
             }
-            integrator_updated = true;
-        }
-    }
-
-    if (key == usdCyclesTokens->cyclesIntegratorVolume_samples) {
-        bool sample_updated = false;
-        integrator->volume_samples
-            = _HdCyclesGetVtValue<int>(value, integrator->volume_samples,
-                                       &sample_updated);
-
-        if (sample_updated) {
-            if (m_useSquareSamples) {
-                integrator->volume_samples = integrator->volume_samples
-                                             * integrator->volume_samples;
+        };
+        r[usdCyclesTokens->cyclesTile_order] = {
+            SettingSession, [](HdCyclesRenderParam& p, const VtValue& value) {
+                static const std::map<TfToken, ccl::TileOrder> tileOrders = {
+                    { usdCyclesTokens->hilbert_spiral,
+                      ccl::TILE_HILBERT_SPIRAL },
+                    { usdCyclesTokens->center, ccl::TILE_CENTER },
+                    { usdCyclesTokens->right_to_left, ccl::TILE_RIGHT_TO_LEFT },
+                    { usdCyclesTokens->left_to_right, ccl::TILE_LEFT_TO_RIGHT },
+                    { usdCyclesTokens->top_to_bottom, ccl::TILE_TOP_TO_BOTTOM },
+                    { usdCyclesTokens->bottom_to_top, ccl::TILE_BOTTOM_TO_TOP },
+                };
+
+                bool updated      = false;
+                TfToken tileOrder = _HdCyclesGetVtValue<TfToken>(value,
+                                                                 TfToken(),
+                                                                 &updated);
+                auto it = tileOrders.find(tileOrder);
+                if (it == tileOrders.end())
+                    return false;
+
+                p._GetSessionParams()->tile_order = it->second;
+                return updated;
             }
-            integrator_updated = true;
-        }
-    }
+        };
+
+        r[usdCyclesTokens->cyclesStart_resolution]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::start_resolution);
+        r[usdCyclesTokens->cyclesPixel_size]
+            = member(SettingSession, session, &ccl::SessionParams::pixel_size);
+        r[usdCyclesTokens->cyclesThreads]
+            = member(SettingSession, session, &ccl::SessionParams::threads);
+        r[usdCyclesTokens->cyclesAdaptive_sampling]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::adaptive_sampling);
+        r[usdCyclesTokens->cyclesUse_profiling]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::use_profiling);
+        r[usdCyclesTokens->cyclesDisplay_buffer_linear]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::display_buffer_linear);
+
+        // The scene inherits the shading system of the session
+        r[usdCyclesTokens->cyclesShading_system] = {
+            SettingSession, [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated          = false;
+                TfToken shadingSystem = _HdCyclesGetVtValue<TfToken>(
+                    value, usdCyclesTokens->svm, &updated);
+
+                ccl::ShadingSystem system = ccl::SHADINGSYSTEM_SVM;
+                if (shadingSystem == usdCyclesTokens->osl)
+                    system = ccl::SHADINGSYSTEM_OSL;
+
+                p._GetSessionParams()->shadingsystem = system;
+                p._GetSceneParams()->shadingsystem   = system;
+                return updated;
+            }
+        };
 
-    if (key == usdCyclesTokens->cyclesIntegratorStart_sample) {
-        integrator->start_sample
-            = _HdCyclesGetVtValue<int>(value, integrator->start_sample,
-                                       &integrator_updated);
-    }
+        // Denoising
 
-    // Caustics
+        r[usdCyclesTokens->cyclesRun_denoising] = {
+            SettingSession, [](HdCyclesRenderParam& p, const VtValue& value) {
+                if (p.m_useTiledRendering) {
+                    TF_WARN("Denoising is not supported with tiled rendering");
+                    return false;
+                }
 
-    if (key == usdCyclesTokens->cyclesIntegratorCaustics_reflective) {
-        integrator->caustics_reflective
-            = _HdCyclesGetVtValue<bool>(value, integrator->caustics_reflective,
-                                        &integrator_updated);
-    }
-    if (key == usdCyclesTokens->cyclesIntegratorCaustics_refractive) {
-        integrator->caustics_refractive
-            = _HdCyclesGetVtValue<bool>(value, integrator->caustics_refractive,
-                                        &integrator_updated);
-    }
+                ccl::SessionParams* params = p._GetSessionParams();
 
-    // Filter
+                bool updated           = false;
+                params->denoising.use = _HdCyclesGetVtValue<int>(
+                    value, params->denoising.use, &updated);
+                return updated;
+            }
+        };
+        r[usdCyclesTokens->cyclesDenoising_start_sample]
+            = member(SettingSession, session,
+                     &ccl::SessionParams::denoising_start_sample);
+
+        // -- Scene
+
+        r[usdCyclesTokens->cyclesBvh_type] = {
+            SettingScene, [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated    = false;
+                TfToken bvhType = _HdCyclesGetVtValue<TfToken>(
+                    value, usdCyclesTokens->bvh_dynamic, &updated);
+
+                if (bvhType == usdCyclesTokens->bvh_dynamic) {
+                    p._GetSceneParams()->bvh_type
+                        = ccl::SceneParams::BVH_DYNAMIC;
+                } else if (bvhType == usdCyclesTokens->bvh_static) {
+                    p._GetSceneParams()->bvh_type
+                        = ccl::SceneParams::BVH_STATIC;
+                } else {
+                    return false;
+                }
+                return updated;
+            }
+        };
+        r[usdCyclesTokens->cyclesCurve_subdivisions]
+            = member(SettingScene, scene,
+                     &ccl::SceneParams::hair_subdivisions);
+        r[usdCyclesTokens->cyclesUse_bvh_spatial_split]
+            = member(SettingScene, scene,
+                     &ccl::SceneParams::use_bvh_spatial_split);
+        r[usdCyclesTokens->cyclesUse_bvh_unaligned_nodes]
+            = member(SettingScene, scene,
+                     &ccl::SceneParams::use_bvh_unaligned_nodes);
+        r[usdCyclesTokens->cyclesNum_bvh_time_steps]
+            = member(SettingScene, scene,
+                     &ccl::SceneParams::num_bvh_time_steps);
+
+        // -- Integrator
+
+        r[usdCyclesTokens->cyclesIntegratorSeed]
+            = member(SettingIntegrator, integrator, &ccl::Integrator::seed);
+        r[usdCyclesTokens->cyclesIntegratorMin_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::min_bounce);
+        r[usdCyclesTokens->cyclesIntegratorMax_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::max_bounce);
+
+        r[usdCyclesTokens->cyclesIntegratorMethod] = {
+            SettingIntegrator,
+            [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated   = false;
+                TfToken method = _HdCyclesGetVtValue<TfToken>(
+                    value, usdCyclesTokens->path, &updated);
+                p.m_cyclesScene->integrator->method
+                    = (method == usdCyclesTokens->path)
+                          ? ccl::Integrator::PATH
+                          : ccl::Integrator::BRANCHED_PATH;
+                return updated;
+            }
+        };
+        r[usdCyclesTokens->cyclesIntegratorSampling_method] = {
+            SettingIntegrator,
+            [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated           = false;
+                TfToken samplingMethod = _HdCyclesGetVtValue<TfToken>(
+                    value, usdCyclesTokens->sobol, &updated);
+
+                if (samplingMethod == usdCyclesTokens->sobol) {
+                    p.m_samplingPattern = ccl::SAMPLING_PATTERN_SOBOL;
+                } else if (samplingMethod == usdCyclesTokens->cmj) {
+                    p.m_samplingPattern = ccl::SAMPLING_PATTERN_CMJ;
+                } else {
+                    p.m_samplingPattern = ccl::SAMPLING_PATTERN_PMJ;
+                }
 
-    if (key == usdCyclesTokens->cyclesIntegratorFilter_glossy) {
-        integrator->filter_glossy
-            = _HdCyclesGetVtValue<float>(value, integrator->filter_glossy,
-                                         &integrator_updated);
-    }
+                // Adaptive sampling keeps PMJ until it is turned off
+                ccl::Integrator* integrator = p.m_cyclesScene->integrator;
+                if (!p._GetSessionParams()->adaptive_sampling)
+                    integrator->sampling_pattern = p.m_samplingPattern;
+                return updated;
+            }
+        };
+
+        r[usdCyclesTokens->cyclesIntegratorMax_diffuse_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::max_diffuse_bounce);
+        r[usdCyclesTokens->cyclesIntegratorMax_glossy_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::max_glossy_bounce);
+        r[usdCyclesTokens->cyclesIntegratorMax_transmission_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::max_transmission_bounce);
+        r[usdCyclesTokens->cyclesIntegratorMax_volume_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::max_volume_bounce);
+        r[usdCyclesTokens->cyclesIntegratorTransparent_min_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::transparent_min_bounce);
+        r[usdCyclesTokens->cyclesIntegratorTransparent_max_bounce]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::transparent_max_bounce);
+        r[usdCyclesTokens->cyclesIntegratorAo_bounces]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::ao_bounces);
+        r[usdCyclesTokens->cyclesIntegratorVolume_max_steps]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::volume_max_steps);
+        r[usdCyclesTokens->cyclesIntegratorVolume_step_size]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::volume_step_rate);
+        r[usdCyclesTokens->cyclesIntegratorAdaptive_threshold]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::adaptive_threshold);
+
+        // Samples
+
+        r[usdCyclesTokens->cyclesIntegratorAa_samples] = samples(
+            &ccl::Integrator::aa_samples);
+        r[usdCyclesTokens->cyclesIntegratorAdaptive_min_samples] = samples(
+            &ccl::Integrator::adaptive_min_samples);
+        r[usdCyclesTokens->cyclesIntegratorDiffuse_samples] = samples(
+            &ccl::Integrator::diffuse_samples);
+        r[usdCyclesTokens->cyclesIntegratorGlossy_samples] = samples(
+            &ccl::Integrator::glossy_samples);
+        r[usdCyclesTokens->cyclesIntegratorTransmission_samples] = samples(
+            &ccl::Integrator::transmission_samples);
+        r[usdCyclesTokens->cyclesIntegratorAo_samples] = samples(
+            &ccl::Integrator::ao_samples);
+        r[usdCyclesTokens->cyclesIntegratorMesh_light_samples] = samples(
+            &ccl::Integrator::mesh_light_samples);
+        r[usdCyclesTokens->cyclesIntegratorSubsurface_samples] = samples(
+            &ccl::Integrator::subsurface_samples);
+        r[usdCyclesTokens->cyclesIntegratorVolume_samples] = samples(
+            &ccl::Integrator::volume_samples);
+
+        r[usdCyclesTokens->cyclesIntegratorStart_sample]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::start_sample);
+
+        // Caustics
+
+        r[usdCyclesTokens->cyclesIntegratorCaustics_reflective]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::caustics_reflective);
+        r[usdCyclesTokens->cyclesIntegratorCaustics_refractive]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::caustics_refractive);
+
+        // Filter
+
+        r[usdCyclesTokens->cyclesIntegratorFilter_glossy]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::filter_glossy);
+        r[usdCyclesTokens->cyclesIntegratorSample_clamp_direct]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::sample_clamp_direct);
+        r[usdCyclesTokens->cyclesIntegratorSample_clamp_indirect]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::sample_clamp_indirect);
+        r[usdCyclesTokens->cyclesIntegratorMotion_blur]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::motion_blur);
+        r[usdCyclesTokens->cyclesIntegratorSample_all_lights_direct]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::sample_all_lights_direct);
+        r[usdCyclesTokens->cyclesIntegratorSample_all_lights_indirect]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::sample_all_lights_indirect);
+        r[usdCyclesTokens->cyclesIntegratorLight_sampling_threshold]
+            = member(SettingIntegrator, integrator,
+                     &ccl::Integrator::light_sampling_threshold);
+
+        // -- Film
+
+        r[usdCyclesTokens->cyclesFilmExposure]
+            = member(SettingFilm, film, &ccl::Film::exposure);
+        r[usdCyclesTokens->cyclesFilmPass_alpha_threshold]
+            = member(SettingFilm, film, &ccl::Film::pass_alpha_threshold);
+
+        r[usdCyclesTokens->cyclesFilmFilter_type] = {
+            SettingFilm, [](HdCyclesRenderParam& p, const VtValue& value) {
+                bool updated   = false;
+                TfToken filter = _HdCyclesGetVtValue<TfToken>(
+                    value, usdCyclesTokens->box, &updated);
+
+                ccl::Film* film = p.m_cyclesScene->film;
+                if (filter == usdCyclesTokens->box) {
+                    film->filter_type = ccl::FilterType::FILTER_BOX;
+                } else if (filter == usdCyclesTokens->gaussian) {
+                    film->filter_type = ccl::FilterType::FILTER_GAUSSIAN;
+                } else {
+                    film->filter_type
+                        = ccl::FilterType::FILTER_BLACKMAN_HARRIS;
+                }
+                return updated;
+            }
+        };
+        r[usdCyclesTokens->cyclesFilmFilter_width]
+            = member(SettingFilm, film, &ccl::Film::filter_width);
+
+        // Mist
+
+        r[usdCyclesTokens->cyclesFilmMist_start]
+            = member(SettingFilm, film, &ccl::Film::mist_start);
+        r[usdCyclesTokens->cyclesFilmMist_depth]
+            = member(SettingFilm, film, &ccl::Film::mist_depth);
+        r[usdCyclesTokens->cyclesFilmMist_falloff]
+            = member(SettingFilm, film, &ccl::Film::mist_falloff);
+
+        // Light
+
+        r[usdCyclesTokens->cyclesFilmUse_light_visibility]
+            = member(SettingFilm, film, &ccl::Film::use_light_visibility);
+
+        // Sampling
+
+        // cyclesFilmUse_adaptive_sampling isn't registered, the film follows
+        // the adaptive sampling of the session in _HandlePasses.
+
+        // -- Background
+
+        r[usdCyclesTokens->cyclesBackgroundAo_factor]
+            = member(SettingBackground, background,
+                     &ccl::Background::ao_factor);
+        r[usdCyclesTokens->cyclesBackgroundAo_distance]
+            = member(SettingBackground, background,
+                     &ccl::Background::ao_distance);
+        r[usdCyclesTokens->cyclesBackgroundUse_shader]
+            = member(SettingBackground, background,
+                     &ccl::Background::use_shader);
+        r[usdCyclesTokens->cyclesBackgroundUse_ao]
+            = member(SettingBackground, background, &ccl::Background::use_ao);
+
+        // Visibility
+
+        r[usdCyclesTokens->cyclesBackgroundVisibilityCamera] = visibility(
+            ccl::PATH_RAY_CAMERA);
+        r[usdCyclesTokens->cyclesBackgroundVisibilityDiffuse] = visibility(
+            ccl::PATH_RAY_DIFFUSE);
+        r[usdCyclesTokens->cyclesBackgroundVisibilityGlossy] = visibility(
+            ccl::PATH_RAY_GLOSSY);
+        r[usdCyclesTokens->cyclesBackgroundVisibilityTransmission]
+            = visibility(ccl::PATH_RAY_TRANSMIT);
+        r[usdCyclesTokens->cyclesBackgroundVisibilityScatter] = visibility(
+            ccl::PATH_RAY_VOLUME_SCATTER);
+
+        // Glass
+
+        r[usdCyclesTokens->cyclesBackgroundTransparent]
+            = member(SettingBackground, background,
+                     &ccl::Background::transparent);
+        r[usdCyclesTokens->cyclesBackgroundTransparent_glass]
+            = member(SettingBackground, background,
+                     &ccl::Background::transparent_glass);
+        r[usdCyclesTokens->cyclesBackgroundTransparent_roughness_threshold]
+            = member(SettingBackground, background,
+                     &ccl::Background::transparent_roughness_threshold);
+
+        // Volume
+
+        r[usdCyclesTokens->cyclesBackgroundVolume_step_size]
+            = member(SettingBackground, background,
+                     &ccl::Background::volume_step_size);
+#endif
 
-    if (key == usdCyclesTokens->cyclesIntegratorSample_clamp_direct) {
-        integrator->sample_clamp_direct
-            = _HdCyclesGetVtValue<float>(value, integrator->sample_clamp_direct,
-                                         &integrator_updated);
-    }
-    if (key == usdCyclesTokens->cyclesIntegratorSample_clamp_indirect) {
-        integrator->sample_clamp_indirect = _HdCyclesGetVtValue<float>(
-            value, integrator->sample_clamp_indirect, &integrator_updated);
-    }
+        // -- Render region, as passed by hosts for UsdRenderSettings
 
-    if (key == usdCyclesTokens->cyclesIntegratorMotion_blur) {
-        integrator->motion_blur
-            = _HdCyclesGetVtValue<bool>(value, integrator->motion_blur,
-                                        &integrator_updated);
-    }
+        r[_tokens->dataWindowNDC] = {
+            SettingDelegate, [](HdCyclesRenderParam& p, const VtValue& value) {
+                return p.SetDataWindow(
+                    _HdCyclesGetVtValue<GfVec4f>(value, p.m_dataWindowNDC));
+            }
+        };
 
-    if (key == usdCyclesTokens->cyclesIntegratorSample_all_lights_direct) {
-        integrator->sample_all_lights_direct = _HdCyclesGetVtValue<bool>(
-            value, integrator->sample_all_lights_direct, &integrator_updated);
-    }
-    if (key == usdCyclesTokens->cyclesIntegratorSample_all_lights_indirect) {
-        integrator->sample_all_lights_indirect = _HdCyclesGetVtValue<bool>(
-            value, integrator->sample_all_lights_indirect, &integrator_updated);
-    }
+        return r;
+    }();
 
-    if (key == usdCyclesTokens->cyclesIntegratorLight_sampling_threshold) {
-        integrator->light_sampling_threshold = _HdCyclesGetVtValue<float>(
-            value, integrator->light_sampling_threshold, &integrator_updated);
-    }
+    return registry;
+}
 
-    if (integrator_updated) {
-        integrator->tag_update(m_cyclesScene);
-        return true;
-    }
+bool
+HdCyclesRenderParam::_ApplyRenderSetting(const TfToken& a_key,
+                                         const RenderSetting& a_setting,
+                                         const VtValue& a_value)
+{
+    // Hosts like Solaris re-send the whole settings map on every change
+    auto applied = m_renderSettings.find(a_key);
+    if (applied != m_renderSettings.end() && applied->second == a_value)
+        return false;
 
-#endif
-    return false;
-}
+    if (!a_setting.apply(*this, a_value))
+        return false;
 
-// -- Film
+    m_renderSettings[a_key] = a_value;
+    return true;
+}
 
 void
-HdCyclesRenderParam::_UpdateFilmFromConfig(bool a_forceInit)
+HdCyclesRenderParam::_TagRenderSettingCategories(uint32_t a_categories)
 {
     if (!m_cyclesScene)
         return;
 
-    static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
+    // Passes depend on the adaptive sampling and denoising session settings
+    if (a_categories & (1u << SettingSession)) {
+        {
+            std::lock_guard<ccl::thread_mutex> lock(m_cyclesScene->mutex);
+            _HandlePasses();
+        }
+        _UpdateDenoising();
+    }
 
-    ccl::Film* film = m_cyclesScene->film;
+    if (a_categories & (1u << SettingIntegrator))
+        m_cyclesScene->integrator->tag_update(m_cyclesScene);
 
-    config.exposure.eval(film->exposure, a_forceInit);
+    if (a_categories & (1u << SettingFilm))
+        m_cyclesScene->film->tag_update(m_cyclesScene);
 
-    film->tag_update(m_cyclesScene);
+    if (a_categories & (1u << SettingBackground))
+        m_cyclesScene->background->tag_update(m_cyclesScene);
+
+    // BVH and curve settings are baked into every geometry, the reset
+    // rebuilds them under the scene lock
+    if (a_categories & (1u << SettingScene)) {
+        MarkChanged(SceneChanged);
+        Interrupt(true);
+    }
 }
 
-void
-HdCyclesRenderParam::_UpdateFilmFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
+bool
+HdCyclesRenderParam::SetRenderSetting(const TfToken& key, const VtValue& value)
 {
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
+    const RenderSettingRegistry& registry = _GetRenderSettingRegistry();
 
-        _HandleFilmRenderSetting(key, value);
-    }
+    auto it = registry.find(key);
+    if (it == registry.end())
+        return false;
+
+    if (!_ApplyRenderSetting(key, it->second, value))
+        return false;
+
+    _TagRenderSettingCategories(1u << it->second.category);
+    return true;
 }
 
 bool
-HdCyclesRenderParam::_HandleFilmRenderSetting(const TfToken& key,
-                                              const VtValue& value)
+HdCyclesRenderParam::_CreateSession()
 {
-#ifdef USE_USD_CYCLES_SCHEMA
-    // -- Film Settings
+    bool foundDevice = SetDeviceType(m_deviceName, m_sessionParams);
 
-    ccl::Film* film   = m_cyclesScene->film;
-    bool film_updated = false;
+    if (!foundDevice)
+        return false;
 
-    if (key == usdCyclesTokens->cyclesFilmExposure) {
-        film->exposure = _HdCyclesGetVtValue<float>(value, film->exposure,
-                                                    &film_updated, false);
-    }
+    // Pooled sessions are only reused with the same start resolution
+    _UpdateStartResolution();
 
-    if (key == usdCyclesTokens->cyclesFilmPass_alpha_threshold) {
-        film->pass_alpha_threshold
-            = _HdCyclesGetVtValue<float>(value, film->pass_alpha_threshold,
-                                         &film_updated, false);
-    }
+    // The pool binds the session callbacks to this render param
+    m_cyclesSession = HdCyclesSessionPool::GetInstance().Acquire(
+        m_sessionParams, this, &m_sessionIsWarm);
 
-    // Filter
+    return m_cyclesSession != nullptr;
+}
 
-    if (key == usdCyclesTokens->cyclesFilmFilter_type) {
-        TfToken filter = _HdCyclesGetVtValue<TfToken>(value,
-                                                      usdCyclesTokens->box,
-                                                      &film_updated);
-        if (filter == usdCyclesTokens->box) {
-            film->filter_type = ccl::FilterType::FILTER_BOX;
-        } else if (filter == usdCyclesTokens->gaussian) {
-            film->filter_type = ccl::FilterType::FILTER_GAUSSIAN;
-        } else {
-            film->filter_type = ccl::FilterType::FILTER_BLACKMAN_HARRIS;
+std::unique_ptr<HdCyclesRenderParam::CompletedTile>
+HdCyclesRenderParam::_ReadTile(ccl::RenderBuffers* a_buffers, int a_x, int a_y,
+                               int a_sample, bool a_skipColor)
+{
+    std::unique_ptr<CompletedTile> tile;
+    {
+        std::lock_guard<std::mutex> lock(m_tilesMutex);
+        if (!m_freeTiles.empty()) {
+            tile = std::move(m_freeTiles.back());
+            m_freeTiles.pop_back();
         }
     }
+    if (!tile)
+        tile.reset(new CompletedTile());
+
+    tile->x      = a_x;
+    tile->y      = a_y;
+    tile->width  = a_buffers->params.width;
+    tile->height = a_buffers->params.height;
+
+    const float exposure   = m_cyclesScene->film->exposure;
+    const size_t numPixels = static_cast<size_t>(tile->width) * tile->height;
+
+    // Cycles holds its tile lock during the callback, the passes are read
+    // without waiting on the Hydra thread
+    const std::shared_ptr<const PassBindings> bindings = _GetPassBindings();
+    tile->bindingsVersion = bindings->version;
+    tile->passes.resize(bindings->bindings.size());
+    for (size_t i = 0; i < bindings->bindings.size(); ++i) {
+        const HdCyclesDefaultAov& aov = DefaultAovs[bindings->bindings[i].aov];
+
+        // Left empty, the blit skips it
+        if (a_skipColor && aov.type == ccl::PASS_COMBINED) {
+            tile->passes[i].clear();
+            continue;
+        }
 
-    if (key == usdCyclesTokens->cyclesFilmFilter_width) {
-        film->filter_width = _HdCyclesGetVtValue<float>(value,
-                                                        film->filter_width,
-                                                        &film_updated, false);
-    }
-
-    // Mist
-
-    if (key == usdCyclesTokens->cyclesFilmMist_start) {
-        film->mist_start = _HdCyclesGetVtValue<float>(value, film->mist_start,
-                                                      &film_updated, false);
+        tile->passes[i].resize(numPixels * HdDataSizeOfFormat(aov.format));
+        _ReadPass(a_buffers, aov, exposure, a_sample,
+                  reinterpret_cast<float*>(tile->passes[i].data()));
     }
+    return tile;
+}
 
-    if (key == usdCyclesTokens->cyclesFilmMist_depth) {
-        film->mist_depth = _HdCyclesGetVtValue<float>(value, film->mist_depth,
-                                                      &film_updated, false);
-    }
+void
+HdCyclesRenderParam::_RecycleTile(std::unique_ptr<CompletedTile> a_tile)
+{
+    std::lock_guard<std::mutex> lock(m_tilesMutex);
+    m_freeTiles.push_back(std::move(a_tile));
+}
 
-    if (key == usdCyclesTokens->cyclesFilmMist_falloff) {
-        film->mist_falloff = _HdCyclesGetVtValue<float>(value,
-                                                        film->mist_falloff,
-                                                        &film_updated, false);
-    }
+void
+HdCyclesRenderParam::_WriteRenderTile(ccl::RenderTile& rtile)
+{
+    // No session, exit out
+    if (!m_cyclesSession)
+        return;
 
-    // Light
+    ccl::RenderBuffers* buffers = rtile.buffers;
 
-    if (key == usdCyclesTokens->cyclesFilmUse_light_visibility) {
-        film->use_light_visibility
-            = _HdCyclesGetVtValue<bool>(value, film->use_light_visibility,
-                                        &film_updated, false);
+    // Progressive renders release a tile of the whole image after each
+    // sample, the session buffers can't be reset until it returns
+    if (!m_useTiledRendering) {
+        _ReadSessionPasses(rtile);
+        return;
     }
 
-    // Sampling
+    // copy data from device
+    if (!buffers->copy_from_device())
+        return;
 
-    // TODO: Check if cycles actually uses this, doesnt appear to...
-    if (key == usdCyclesTokens->cyclesFilmUse_adaptive_sampling) {
-        film->use_adaptive_sampling
-            = _HdCyclesGetVtValue<bool>(value, film->use_adaptive_sampling,
-                                        &film_updated, false);
+    // Adjust absolute sample number to the range.
+    int sample = rtile.sample;
+    const int range_start_sample
+        = m_cyclesSession->tile_manager.range_start_sample;
+    if (range_start_sample != -1) {
+        sample -= range_start_sample;
     }
 
-    if (film_updated) {
-        film->tag_update(m_cyclesScene);
-        return true;
-    }
+    // The render pass blits it on its next execution
+    std::unique_ptr<CompletedTile> tile = _ReadTile(buffers, rtile.x, rtile.y,
+                                                    sample, false);
 
-#endif
-    return false;
+    std::lock_guard<std::mutex> lock(m_tilesMutex);
+    m_completedTiles.push_back(std::move(tile));
 }
 
 void
-HdCyclesRenderParam::_UpdateBackgroundFromConfig(bool a_forceInit)
+HdCyclesRenderParam::_ReadSessionPasses(ccl::RenderTile& rtile)
 {
-    if (!m_cyclesScene)
+    ccl::RenderBuffers* buffers = rtile.buffers;
+
+    // Low resolution start passes don't fill the buffers
+    if (rtile.w != buffers->params.width || rtile.h != buffers->params.height
+        || rtile.sample <= 0)
         return;
 
-    static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
+    // Sampling waits for the read, so the passes are only read as often as
+    // the display is updated. The first sample after a reset and the last
+    // one are always read.
+    const auto now = std::chrono::steady_clock::now();
+    std::chrono::steady_clock::time_point resetTime;
+    int totalSamples;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        resetTime    = m_renderStats.resetTime;
+        totalSamples = m_renderStats.totalSamples;
+    }
+    const std::chrono::duration<double> sinceRead = now
+                                                    - m_sessionPassesReadTime;
+    const std::chrono::duration<double> sinceReset = now - resetTime;
+    const bool lastSample = rtile.sample >= totalSamples
+                            || (m_timeLimit > 0.0
+                                && sinceReset.count() >= m_timeLimit);
+    if (!lastSample && m_sessionPassesReadTime > resetTime
+        && sinceRead.count()
+               < m_cyclesSession->params.progressive_update_timeout)
+        return;
 
-    ccl::Background* background = m_cyclesScene->background;
+    // Like the display buffer, this is read while the session renders
+    if (!buffers->copy_from_device())
+        return;
 
-    if (config.enable_transparent_background.value)
-        background->transparent = true;
+    m_sessionPassesReadTime = now;
 
+    std::unique_ptr<CompletedTile> passes
+        = _ReadTile(buffers, buffers->params.full_x, buffers->params.full_y,
+                    rtile.sample, !IsDisplayBufferFloat());
 
-    background->tag_update(m_cyclesScene);
+    // Only the latest sample is kept for the render pass
+    {
+        std::lock_guard<std::mutex> lock(m_sessionPassesMutex);
+        passes.swap(m_sessionPasses);
+    }
+    if (passes)
+        _RecycleTile(std::move(passes));
 }
 
-void
-HdCyclesRenderParam::_UpdateBackgroundFromRenderSettings(
-    HdRenderSettingsMap const& settingsMap)
+std::shared_ptr<const HdCyclesRenderParam::PassBindings>
+HdCyclesRenderParam::_GetPassBindings()
 {
-    for (auto& entry : settingsMap) {
-        TfToken key   = entry.first;
-        VtValue value = entry.second;
-        _HandleBackgroundRenderSetting(key, value);
-    }
+    std::lock_guard<std::mutex> lock(m_aovsMutex);
+    return m_passBindings;
 }
 
-bool
-HdCyclesRenderParam::_HandleBackgroundRenderSetting(const TfToken& key,
-                                                    const VtValue& value)
+void
+HdCyclesRenderParam::_BlitTile(const PassBindings& a_bindings,
+                               const CompletedTile& a_tile)
 {
-#ifdef USE_USD_CYCLES_SCHEMA
-
-    // -- Background Settings
+    for (size_t i = 0; i < a_bindings.bindings.size(); ++i) {
+        if (a_tile.passes[i].empty())
+            continue;
 
-    ccl::Background* background = m_cyclesScene->background;
-    bool background_updated     = false;
-
-    if (key == usdCyclesTokens->cyclesBackgroundAo_factor) {
-        background->ao_factor
-            = _HdCyclesGetVtValue<float>(value, background->ao_factor,
-                                         &background_updated);
-    }
-    if (key == usdCyclesTokens->cyclesBackgroundAo_distance) {
-        background->ao_distance
-            = _HdCyclesGetVtValue<float>(value, background->ao_distance,
-                                         &background_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesBackgroundUse_shader) {
-        background->use_shader
-            = _HdCyclesGetVtValue<bool>(value, background->use_shader,
-                                        &background_updated);
-    }
-    if (key == usdCyclesTokens->cyclesBackgroundUse_ao) {
-        background->use_ao = _HdCyclesGetVtValue<bool>(value,
-                                                       background->use_ao,
-                                                       &background_updated);
-    }
+        const HdFormat format = DefaultAovs[a_bindings.bindings[i].aov].format;
+        const uint8_t* data   = a_tile.passes[i].data();
 
-    // Visibility
-
-    bool visCamera, visDiffuse, visGlossy, visTransmission, visScatter;
-    visCamera = visDiffuse = visGlossy = visTransmission = visScatter = true;
-
-    unsigned int visFlags = 0;
-
-    if (key == usdCyclesTokens->cyclesBackgroundVisibilityCamera) {
-        visCamera = _HdCyclesGetVtValue<bool>(value, visCamera,
-                                              &background_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesBackgroundVisibilityDiffuse) {
-        visDiffuse = _HdCyclesGetVtValue<bool>(value, visDiffuse,
-                                               &background_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesBackgroundVisibilityGlossy) {
-        visGlossy = _HdCyclesGetVtValue<bool>(value, visGlossy,
-                                              &background_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesBackgroundVisibilityTransmission) {
-        visTransmission = _HdCyclesGetVtValue<bool>(value, visTransmission,
-                                                    &background_updated);
-    }
-
-    if (key == usdCyclesTokens->cyclesBackgroundVisibilityScatter) {
-        visScatter = _HdCyclesGetVtValue<bool>(value, visScatter,
-                                               &background_updated);
+        for (HdCyclesRenderBuffer* rb : a_bindings.bindings[i].buffers) {
+            if (rb->GetFormat() == HdFormatInvalid)
+                continue;
+            rb->BlitTile(format, a_tile.x, a_tile.y, a_tile.width,
+                         a_tile.height, 0, a_tile.width, data);
+        }
     }
+}
 
-    visFlags |= visCamera ? ccl::PATH_RAY_CAMERA : 0;
-    visFlags |= visDiffuse ? ccl::PATH_RAY_DIFFUSE : 0;
-    visFlags |= visGlossy ? ccl::PATH_RAY_GLOSSY : 0;
-    visFlags |= visTransmission ? ccl::PATH_RAY_TRANSMIT : 0;
-    visFlags |= visScatter ? ccl::PATH_RAY_VOLUME_SCATTER : 0;
+void
+HdCyclesRenderParam::BlitCompletedTiles()
+{
+    if (!m_useTiledRendering)
+        return;
 
-    background->visibility = visFlags;
+    const bool converged = IsConverged();
 
-    // Glass
+    // Blitted without m_aovsMutex, the tile callbacks never wait on it
+    const std::shared_ptr<const PassBindings> bindings = _GetPassBindings();
 
-    if (key == usdCyclesTokens->cyclesBackgroundTransparent) {
-        background->transparent
-            = _HdCyclesGetVtValue<bool>(value, background->transparent,
-                                        &background_updated);
+    // Swapped so the tile callbacks only wait for the swap
+    {
+        std::lock_guard<std::mutex> lock(m_tilesMutex);
+        m_blitTiles.swap(m_completedTiles);
     }
 
-    if (key == usdCyclesTokens->cyclesBackgroundTransparent_glass) {
-        background->transparent_glass
-            = _HdCyclesGetVtValue<bool>(value, background->transparent_glass,
-                                        &background_updated);
+    int numTiles = 0;
+    for (const std::unique_ptr<CompletedTile>& tile : m_blitTiles) {
+        // Tiles of previous bindings don't match the pass bindings
+        if (tile->bindingsVersion == bindings->version) {
+            _BlitTile(*bindings, *tile);
+            ++numTiles;
+        }
     }
 
-    if (key
-        == usdCyclesTokens->cyclesBackgroundTransparent_roughness_threshold) {
-        background->transparent_roughness_threshold = _HdCyclesGetVtValue<float>(
-            value, background->transparent_roughness_threshold,
-            &background_updated);
+    {
+        std::lock_guard<std::mutex> lock(m_tilesMutex);
+        std::move(m_blitTiles.begin(), m_blitTiles.end(),
+                  std::back_inserter(m_freeTiles));
     }
+    m_blitTiles.clear();
 
-    // Volume
-
-    if (key == usdCyclesTokens->cyclesBackgroundVolume_step_size) {
-        background->volume_step_size
-            = _HdCyclesGetVtValue<float>(value, background->volume_step_size,
-                                         &background_updated);
+    // Readers see every tile of this call at once
+    for (const PassBinding& binding : bindings->bindings) {
+        for (HdCyclesRenderBuffer* rb : binding.buffers) {
+            rb->SetConverged(converged);
+            if (numTiles > 0)
+                rb->SwapBuffers();
+        }
     }
 
-    if (background_updated) {
-        background->tag_update(m_cyclesScene);
-        return true;
+    if (numTiles > 0) {
+        std::lock_guard<std::mutex> statsLock(m_statsMutex);
+        m_renderStats.completedTiles += numTiles;
     }
-
-#endif
-    return false;
 }
 
 void
-HdCyclesRenderParam::_HandlePasses()
+HdCyclesRenderParam::BlitSessionPasses()
 {
-    // TODO: These might need to live elsewhere when we fully implement aovs/passes
-    m_bufferParams.passes.clear();
+    if (!m_cyclesSession || m_useTiledRendering)
+        return;
 
-    if (m_useTiledRendering) {
-        for (HdCyclesDefaultAov& aov : DefaultAovs) {
-            ccl::Pass::add(aov.type, m_bufferParams.passes, aov.name.c_str());
-        }
-    } else {
-        ccl::Pass::add(ccl::PASS_COMBINED, m_bufferParams.passes, "Combined");
+    // Read on the session thread after the last sample
+    std::unique_ptr<CompletedTile> passes;
+    {
+        std::lock_guard<std::mutex> lock(m_sessionPassesMutex);
+        passes.swap(m_sessionPasses);
     }
+    if (!passes)
+        return;
 
-    m_cyclesScene->film->tag_passes_update(m_cyclesScene,
-                                           m_bufferParams.passes);
-}
-
-bool
-HdCyclesRenderParam::SetRenderSetting(const TfToken& key, const VtValue& value)
-{
-    // This has some inherent performance overheads (runs multiple times, unecessary)
-    // however for now, this works the most clearly due to Cycles restrictions
-#ifdef USE_USD_CYCLES_SCHEMA
-    _HandleSessionRenderSetting(key, value);
-    _HandleSceneRenderSetting(key, value);
-    _HandleIntegratorRenderSetting(key, value);
-    _HandleFilmRenderSetting(key, value);
-    _HandleBackgroundRenderSetting(key, value);
-#endif
-    return false;
-}
-
-bool
-HdCyclesRenderParam::_CreateSession()
-{
-    bool foundDevice = SetDeviceType(m_deviceName, m_sessionParams);
+    const bool converged = IsConverged();
 
-    if (!foundDevice)
-        return false;
+    const std::shared_ptr<const PassBindings> bindings = _GetPassBindings();
+    if (passes->bindingsVersion == bindings->version) {
+        const bool fullImage = passes->x == 0 && passes->y == 0;
 
-    m_cyclesSession = new ccl::Session(m_sessionParams);
+        for (size_t i = 0; i < bindings->bindings.size(); ++i) {
+            std::vector<uint8_t>& pass = passes->passes[i];
+            if (pass.empty())
+                continue;
 
-    m_cyclesSession->write_render_tile_cb
-        = std::bind(&HdCyclesRenderParam::_WriteRenderTile, this, ccl::_1);
-    m_cyclesSession->update_render_tile_cb
-        = std::bind(&HdCyclesRenderParam::_UpdateRenderTile, this, ccl::_1,
-                    ccl::_2);
+            const HdFormat format = DefaultAovs[bindings->bindings[i].aov].format;
+            const std::vector<HdCyclesRenderBuffer*>& buffers
+                = bindings->bindings[i].buffers;
+            for (size_t b = 0; b < buffers.size(); ++b) {
+                HdCyclesRenderBuffer* rb = buffers[b];
+                if (rb->GetFormat() == HdFormatInvalid)
+                    continue;
+
+                // The last buffer takes the pass without a copy if it has
+                // its format and size, the pass gets its old back buffer
+                const bool exchanged = fullImage && b + 1 == buffers.size()
+                                       && rb->ExchangeBackBuffer(
+                                           format, passes->width,
+                                           passes->height, pass);
+                if (!exchanged) {
+                    rb->BlitTile(format, passes->x, passes->y, passes->width,
+                                 passes->height, 0, passes->width,
+                                 pass.data());
+                }
 
-    m_cyclesSession->progress.set_update_callback(
-        std::bind(&HdCyclesRenderParam::_SessionUpdateCallback, this));
+                rb->SetConverged(converged);
+                rb->SwapBuffers();
+            }
+        }
+    }
 
-    return true;
+    _RecycleTile(std::move(passes));
 }
 
 void
-HdCyclesRenderParam::_WriteRenderTile(ccl::RenderTile& rtile)
+HdCyclesRenderParam::SetAovBindings(HdRenderPassAovBindingVector const& a_aovs)
 {
-    // No session, exit out
-    if (!m_cyclesSession)
-        return;
-
-    if (!m_useTiledRendering)
-        return;
-
-    const int x = rtile.x;
-    const int y = rtile.y;
-    const int w = rtile.w;
-    const int h = rtile.h;
-
-    ccl::RenderBuffers* buffers = rtile.buffers;
-
-    // copy data from device
-    if (!buffers->copy_from_device())
-        return;
-
-    // Adjust absolute sample number to the range.
-    int sample = rtile.sample;
-    const int range_start_sample
-        = m_cyclesSession->tile_manager.range_start_sample;
-    if (range_start_sample != -1) {
-        sample -= range_start_sample;
-    }
-
-    const float exposure = m_cyclesScene->film->exposure;
-
-    if (!m_aovs.empty()) {
-        // Blit from the framebuffer to currently selected aovs...
-        for (auto& aov : m_aovs) {
-            if (!TF_VERIFY(aov.renderBuffer != nullptr)) {
+    m_aovs = a_aovs;
+
+    auto bindings     = std::make_shared<PassBindings>();
+    bindings->version = _GetPassBindings()->version + 1;
+    for (size_t i = 0; i < DefaultAovs.size(); ++i) {
+        PassBinding binding;
+        binding.aov = i;
+        for (const HdRenderPassAovBinding& aov : m_aovs) {
+            if (aov.aovName != DefaultAovs[i].token)
                 continue;
-            }
-
-            auto* rb = static_cast<HdCyclesRenderBuffer*>(aov.renderBuffer);
-
-            if (rb == nullptr) {
-                continue;
-            }
-
-            if (rb->GetFormat() == HdFormatInvalid) {
+            if (!TF_VERIFY(aov.renderBuffer != nullptr))
                 continue;
-            }
-
-            for (HdCyclesDefaultAov& cyclesAov : DefaultAovs) {
-                if (aov.aovName == cyclesAov.token) {
-                    rb->SetConverged(IsConverged());
-
-                    // Pixels we will use to get from cycles.
-                    int numComponents = HdGetComponentCount(cyclesAov.format);
-
-                    ccl::vector<float> tileData(w * h * numComponents);
+            binding.buffers.push_back(
+                static_cast<HdCyclesRenderBuffer*>(aov.renderBuffer));
+        }
+        if (!binding.buffers.empty())
+            bindings->bindings.push_back(std::move(binding));
+    }
 
-                    bool read = buffers->get_pass_rect(cyclesAov.name.c_str(),
-                                                       exposure, sample,
-                                                       numComponents,
-                                                       &tileData[0]);
+    {
+        std::lock_guard<std::mutex> lock(m_aovsMutex);
+        m_passBindings = std::move(bindings);
+    }
 
-                    if (!read) {
-                        memset(&tileData[0], 0,
-                               tileData.size() * sizeof(float));
-                    }
+    if (!m_cyclesScene)
+        return;
 
-                    rb->BlitTile(cyclesAov.format, rtile.x, rtile.y, rtile.w,
-                                 rtile.h, 0, rtile.w,
-                                 reinterpret_cast<uint8_t*>(tileData.data()));
-                }
-            }
-        }
+    // New passes need new buffers, allocated by the next reset
+    const ccl::vector<ccl::Pass> passes = m_bufferParams.passes;
+    {
+        std::lock_guard<ccl::thread_mutex> lock(m_cyclesScene->mutex);
+        _HandlePasses();
     }
+    _UpdateDenoising();
+
+    if (!ccl::Pass::equals(passes, m_bufferParams.passes))
+        Interrupt();
 }
 
 void
@@ -1407,7 +1800,13 @@ HdCyclesRenderParam::_CreateScene()
 {
     static const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
 
-    m_cyclesScene = new ccl::Scene(m_sceneParams, m_cyclesSession->device);
+    if (m_sessionIsWarm && m_cyclesSession->scene) {
+        // Emptied when released, the device keeps its kernels and textures
+        m_cyclesScene         = m_cyclesSession->scene;
+        m_cyclesScene->params = m_sceneParams;
+    } else {
+        m_cyclesScene = new ccl::Scene(m_sceneParams, m_cyclesSession->device);
+    }
 
     m_width  = config.render_width.value;
     m_height = config.render_height.value;
@@ -1419,18 +1818,25 @@ HdCyclesRenderParam::_CreateScene()
 
     m_cyclesSession->scene = m_cyclesScene;
 
-    m_bufferParams.width       = m_width;
-    m_bufferParams.height      = m_height;
-    m_bufferParams.full_width  = m_width;
-    m_bufferParams.full_height = m_height;
+    _UpdateBufferParams();
 
     default_vcol_surface = HdCyclesCreateDefaultShader();
 
     default_vcol_surface->tag_update(m_cyclesScene);
     m_cyclesScene->shaders.push_back(default_vcol_surface);
 
-    SetBackgroundShader(nullptr);
+    // Owned by the scene, its graph is swapped when the lights change
+    m_defaultBackground       = new ccl::Shader();
+    m_defaultBackground->name = "default_background";
+    m_defaultBackground->set_graph(_CreateBackgroundGraph(true));
+    m_defaultBackground->tag_update(m_cyclesScene);
+    m_defaultBackgroundEmissive = true;
+    m_cyclesScene->shaders.push_back(m_defaultBackground);
+
+    m_cyclesScene->default_background = m_defaultBackground;
+    m_cyclesScene->background->tag_update(m_cyclesScene);
 
+    _ResetRenderStats();
     m_cyclesSession->reset(m_bufferParams, m_sessionParams.samples);
 
     return true;
@@ -1475,55 +1881,196 @@ HdCyclesRenderParam::ResumeRender()
 void
 HdCyclesRenderParam::Interrupt(bool a_forceUpdate)
 {
-    m_shouldUpdate = true;
-    PauseRender();
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_interruptMutex);
+    if (!m_shouldUpdate && !m_cameraChanged)
+        m_firstInterruptTime = now;
+    m_lastInterruptTime = now;
+    m_shouldUpdate      = true;
+}
+
+void
+HdCyclesRenderParam::InterruptCamera()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_interruptMutex);
+    if (!m_shouldUpdate && !m_cameraChanged)
+        m_firstInterruptTime = now;
+    m_lastInterruptTime = now;
+    m_cameraChanged     = true;
+}
+
+bool
+HdCyclesRenderParam::_IsInterruptDue()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    std::lock_guard<std::mutex> lock(m_interruptMutex);
+    if (!m_shouldUpdate && !m_cameraChanged)
+        return true;
+
+    return (now - m_lastInterruptTime) >= m_interruptWindow
+           || (now - m_firstInterruptTime) >= m_interruptLatency;
+}
+
+void
+HdCyclesRenderParam::MarkChanged(uint32_t a_changes)
+{
+    if (a_changes != NoChanges)
+        m_pendingChanges.fetch_or(a_changes);
+}
+
+void
+HdCyclesRenderParam::StagePrim(HdCyclesStagedPrim* a_prim)
+{
+    std::lock_guard<std::mutex> lock(m_stagedPrimsMutex);
+    m_stagedPrims.push_back(a_prim);
+}
+
+void
+HdCyclesRenderParam::UnstagePrim(HdCyclesStagedPrim* a_prim)
+{
+    std::lock_guard<std::mutex> lock(m_stagedPrimsMutex);
+    m_stagedPrims.erase(std::remove(m_stagedPrims.begin(), m_stagedPrims.end(),
+                                    a_prim),
+                        m_stagedPrims.end());
+}
+
+std::unique_lock<ccl::thread_mutex>
+HdCyclesRenderParam::LockScene()
+{
+    return std::unique_lock<ccl::thread_mutex>(m_cyclesScene->mutex);
 }
 
 void
 HdCyclesRenderParam::CommitResources()
 {
-    if (m_shouldUpdate) {
-        if (m_cyclesScene->lights.size() > 0) {
-            if (!m_hasDomeLight)
-                SetBackgroundShader(nullptr, false);
+    // Let edits accumulate while the user is still manipulating the scene,
+    // everything staged so far is committed with the reset.
+    if (!_IsInterruptDue())
+        return;
+
+    // Publish everything the prims converted in parallel during Sync along
+    // with the queued scene edits. This is the only place rprims touch the
+    // live scene, so the lock is held once.
+    std::vector<HdCyclesStagedPrim*> stagedPrims;
+    {
+        std::lock_guard<std::mutex> lock(m_stagedPrimsMutex);
+        stagedPrims.swap(m_stagedPrims);
+    }
+
+    // A prim synced more than once between two commits is staged twice
+    std::sort(stagedPrims.begin(), stagedPrims.end());
+    stagedPrims.erase(std::unique(stagedPrims.begin(), stagedPrims.end()),
+                      stagedPrims.end());
+
+    bool hasSceneEdits = false;
+    {
+        std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+        hasSceneEdits = m_hasSceneEdits;
+    }
+
+    if (hasSceneEdits || !stagedPrims.empty()) {
+        HD_CYCLES_TRACE_SCOPE("HdCyclesRenderParam::CommitResources");
+
+        auto syncStart = std::chrono::steady_clock::now();
+
+        std::unique_lock<ccl::thread_mutex> sceneLock(m_cyclesScene->mutex,
+                                                      std::defer_lock);
+        if (m_overlapSync) {
+            // The session holds the scene mutex while it updates the device.
+            // Rather than stalling Hydra until that is done, the staged prims
+            // go back to the queue and are published by a later commit.
+            // Raising an interrupt keeps IsConverged false so the host keeps
+            // polling until that commit happens. Sampling isn't paused, the
+            // reset hands the new data over to the session.
+            if (!sceneLock.try_lock()) {
+                {
+                    std::lock_guard<std::mutex> lock(m_stagedPrimsMutex);
+                    m_stagedPrims.insert(m_stagedPrims.end(),
+                                         stagedPrims.begin(),
+                                         stagedPrims.end());
+                }
+                Interrupt();
+                return;
+            }
         } else {
-            SetBackgroundShader(nullptr, true);
+            PauseRender();
+            sceneLock.lock();
+        }
+
+        for (HdCyclesStagedPrim* prim : stagedPrims) {
+            prim->CommitStaged(m_cyclesScene);
         }
+        // Includes the membership changes queued by the staged prims
+        _ApplySceneEdits();
+        sceneLock.unlock();
+
+        std::chrono::duration<double> syncTime
+            = std::chrono::steady_clock::now() - syncStart;
+        {
+            std::lock_guard<std::mutex> lock(m_statsMutex);
+            m_renderStats.syncTime = syncTime.count();
+        }
+
+        Interrupt();
+    }
 
+    bool shouldUpdate  = false;
+    bool cameraChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(m_interruptMutex);
+        shouldUpdate    = m_shouldUpdate;
+        cameraChanged   = m_cameraChanged;
+        m_shouldUpdate  = false;
+        m_cameraChanged = false;
+    }
+
+    if (shouldUpdate) {
         CyclesReset(false);
-        m_shouldUpdate = false;
         ResumeRender();
+    } else if (cameraChanged) {
+        // Like the staged prims, a camera reset that would wait for the
+        // device update of the session is retried by a later commit
+        if (_ResetCamera())
+            ResumeRender();
+        else
+            InterruptCamera();
     }
+
+    _UpdateMemoryStats();
+
+    // One frame of conversion timings per flush
+    HdCyclesTrace::GetInstance().Flush();
 }
 
 void
-HdCyclesRenderParam::SetBackgroundShader(ccl::Shader* a_shader, bool a_emissive)
-{
-    if (a_shader)
-        m_cyclesScene->default_background = a_shader;
-    else {
-        // TODO: These aren't properly destroyed from memory
-
-        // Create empty background shader
-        m_cyclesScene->default_background        = new ccl::Shader();
-        m_cyclesScene->default_background->name  = "default_background";
-        m_cyclesScene->default_background->graph = new ccl::ShaderGraph();
-        if (a_emissive) {
-            ccl::BackgroundNode* bgNode = new ccl::BackgroundNode();
-            bgNode->color               = ccl::make_float3(0.6f, 0.6f, 0.6f);
-
-            m_cyclesScene->default_background->graph->add(bgNode);
-
-            ccl::ShaderNode* out
-                = m_cyclesScene->default_background->graph->output();
-            m_cyclesScene->default_background->graph->connect(
-                bgNode->output("Background"), out->input("Surface"));
+HdCyclesRenderParam::_UpdateBackgroundShader()
+{
+    // The shader of the first dome light lights the world, the default
+    // background only lights scenes without lights
+    ccl::Shader* domeShader = nullptr;
+    for (ccl::Light* light : m_cyclesScene->lights) {
+        if (light->type == ccl::LIGHT_BACKGROUND && light->shader) {
+            domeShader = light->shader;
+            break;
         }
+    }
 
-        m_cyclesScene->default_background->tag_update(m_cyclesScene);
-
-        m_cyclesScene->shaders.push_back(m_cyclesScene->default_background);
+    const bool emissive = m_cyclesScene->lights.empty();
+    if (!domeShader && emissive != m_defaultBackgroundEmissive) {
+        m_defaultBackground->set_graph(_CreateBackgroundGraph(emissive));
+        m_defaultBackground->tag_update(m_cyclesScene);
+        m_defaultBackgroundEmissive = emissive;
     }
+
+    ccl::Shader* shader = domeShader ? domeShader : m_defaultBackground;
+    if (m_cyclesScene->default_background == shader)
+        return;
+
+    m_cyclesScene->default_background = shader;
     m_cyclesScene->background->tag_update(m_cyclesScene);
 }
 
@@ -1568,15 +2115,9 @@ bool
 HdCyclesRenderParam::_SetDevice(const ccl::DeviceType& a_deviceType,
                                 ccl::SessionParams& params)
 {
-    std::vector<ccl::DeviceInfo> devices = ccl::Device::available_devices(
-        (ccl::DeviceTypeMask)(1 << a_deviceType));
-
-    bool device_available = false;
-
-    if (!devices.empty()) {
-        params.device    = devices.front();
-        device_available = true;
-    }
+    // Devices are enumerated once per process
+    bool device_available = HdCyclesSessionPool::GetInstance().GetDevice(
+        a_deviceType, &params.device);
 
     if (params.device.type == ccl::DEVICE_NONE || !device_available) {
         TF_RUNTIME_ERROR("No device available exiting.");
@@ -1592,57 +2133,132 @@ HdCyclesRenderParam::_SetDevice(const ccl::DeviceType& a_deviceType,
 void
 HdCyclesRenderParam::_CyclesStart()
 {
-    m_cyclesSession->start();
+    HdCyclesSessionPool::GetInstance().Start(m_cyclesSession);
+}
+
+namespace {
+
+template<typename T>
+void
+_DeleteNodes(ccl::vector<T*>& a_nodes)
+{
+    for (T* node : a_nodes)
+        delete node;
+    a_nodes.clear();
+}
+
+void
+_ResetNodeToDefaults(ccl::Node* a_node)
+{
+    for (const ccl::SocketType& socket : a_node->type->inputs)
+        a_node->set_default_value(socket);
 }
 
+}  // namespace
+
 void
 HdCyclesRenderParam::_CyclesExit()
 {
     m_cyclesSession->set_pause(true);
 
+    HdCyclesSessionPool& pool = HdCyclesSessionPool::GetInstance();
+
     m_cyclesScene->mutex.lock();
 
-    m_cyclesScene->shaders.clear();
-    m_cyclesScene->geometry.clear();
-    m_cyclesScene->objects.clear();
-    m_cyclesScene->lights.clear();
-    m_cyclesScene->particle_systems.clear();
+    // Releases the nodes still queued for removal
+    _ApplySceneEdits();
+
+    if (pool.IsEnabled()) {
+        // Hand back an empty scene with default settings, the next render
+        // param applies its own settings on top
+        _DeleteNodes(m_cyclesScene->objects);
+        _DeleteNodes(m_cyclesScene->geometry);
+        _DeleteNodes(m_cyclesScene->lights);
+        _DeleteNodes(m_cyclesScene->particle_systems);
+        _DeleteNodes(m_cyclesScene->shaders);
+
+        _ResetNodeToDefaults(m_cyclesScene->camera);
+        _ResetNodeToDefaults(m_cyclesScene->dicing_camera);
+        _ResetNodeToDefaults(m_cyclesScene->film);
+        _ResetNodeToDefaults(m_cyclesScene->integrator);
+        _ResetNodeToDefaults(m_cyclesScene->background);
+
+        // Recreates the default shaders and tags every manager
+        m_cyclesScene->reset();
+    } else {
+        m_cyclesScene->shaders.clear();
+        m_cyclesScene->geometry.clear();
+        m_cyclesScene->objects.clear();
+        m_cyclesScene->lights.clear();
+        m_cyclesScene->particle_systems.clear();
+    }
 
     m_cyclesScene->mutex.unlock();
 
-    if (m_cyclesSession) {
-        delete m_cyclesSession;
-        m_cyclesSession = nullptr;
-    }
+    // Stops the callbacks into this render param, deletes the session if
+    // it isn't kept
+    pool.Release(m_cyclesSession);
+
+    m_cyclesSession     = nullptr;
+    m_cyclesScene       = nullptr;
+    m_defaultBackground = nullptr;
 }
 
 // TODO: Refactor these two resets
 void
 HdCyclesRenderParam::CyclesReset(bool a_forceUpdate)
 {
+    HD_CYCLES_TRACE_SCOPE("HdCyclesRenderParam::CyclesReset");
+
     m_cyclesScene->mutex.lock();
 
     m_cyclesSession->progress.reset();
 
-    if (m_curveUpdated || m_meshUpdated || m_geometryUpdated
-        || m_shadersUpdated) {
+    const uint32_t changes = m_pendingChanges.exchange(NoChanges);
+
+    // New or removed geometry and objects, everything has to be repacked
+    if (changes & TopologyChanged) {
         m_cyclesScene->geometry_manager->tag_update(m_cyclesScene);
-        m_geometryUpdated = false;
-        m_meshUpdated     = false;
+        m_cyclesScene->object_manager->tag_update(m_cyclesScene);
     }
 
-    if (m_curveUpdated) {
-        m_curveUpdated = false;
+    // Only geometry nodes tagged by their prims get their attributes and
+    // BVH rebuilt, untouched geometry is just repacked
+    if (changes & GeometryChanged) {
+        m_cyclesScene->geometry_manager->need_update = true;
+        m_cyclesScene->object_manager->need_update   = true;
     }
 
-    if (m_objectsUpdated || m_shadersUpdated) {
-        m_cyclesScene->object_manager->tag_update(m_cyclesScene);
-        m_objectsUpdated = false;
-        m_shadersUpdated = false;
+    // Transforms and visibility live in the object manager, but this
+    // Cycles version builds the instance level BVH, with the object
+    // visibility, and applies static transforms in
+    // GeometryManager::device_update. Object::tag_update sets both flags for
+    // the same reason. No geometry node is tagged, so no geometry BVH is
+    // rebuilt and no attribute re-evaluated.
+    if (changes & (TransformChanged | VisibilityChanged)) {
+        m_cyclesScene->object_manager->need_update   = true;
+        m_cyclesScene->geometry_manager->need_update = true;
+    }
+
+    if (changes & VisibilityChanged) {
+        m_cyclesScene->camera->need_flags_update = true;
+    }
+
+    // Shader::tag_update already flags geometry and lights when a shader
+    // starts or stops needing them (displacement, emission, volume)
+    if (changes & ShaderChanged) {
+        m_cyclesScene->shader_manager->need_update = true;
     }
-    if (m_lightsUpdated) {
+
+    if (changes & LightChanged) {
         m_cyclesScene->light_manager->tag_update(m_cyclesScene);
-        m_lightsUpdated = false;
+    }
+
+    if (changes & SceneChanged) {
+        for (ccl::Geometry* geom : m_cyclesScene->geometry) {
+            geom->tag_update(m_cyclesScene, true);
+        }
+        m_cyclesScene->object_manager->tag_update(m_cyclesScene);
     }
 
     if (a_forceUpdate) {
@@ -1651,20 +2267,42 @@ HdCyclesRenderParam::CyclesReset(bool a_forceUpdate)
         m_cyclesScene->film->tag_update(m_cyclesScene);
     }
 
+    _UpdateBackgroundShader();
+
+    _ResetRenderStats();
     m_cyclesSession->reset(m_bufferParams, m_cyclesSession->params.samples);
     m_cyclesScene->mutex.unlock();
 }
 
+bool
+HdCyclesRenderParam::_ResetCamera()
+{
+    HD_CYCLES_TRACE_SCOPE("HdCyclesRenderParam::_ResetCamera");
+
+    // The camera is already tagged, the device update of the session only
+    // uploads it. Scene changes recorded since still wait for a full reset.
+    std::unique_lock<ccl::thread_mutex> lock(m_cyclesScene->mutex,
+                                             std::try_to_lock);
+    if (!lock.owns_lock())
+        return false;
+
+    m_cyclesSession->progress.reset();
+
+    _ResetRenderStats();
+    m_cyclesSession->reset(m_bufferParams, m_cyclesSession->params.samples);
+    return true;
+}
+
 void
 HdCyclesRenderParam::SetViewport(int w, int h)
 {
     m_width  = w;
     m_height = h;
 
-    m_bufferParams.width          = m_width;
-    m_bufferParams.height         = m_height;
-    m_bufferParams.full_width     = m_width;
-    m_bufferParams.full_height    = m_height;
+    _UpdateBufferParams();
+
+    // Same as _ResetCamera, the session may be updating the scene
+    m_cyclesScene->mutex.lock();
     m_cyclesScene->camera->width  = m_width;
     m_cyclesScene->camera->height = m_height;
     m_cyclesScene->camera->compute_auto_viewplane();
@@ -1673,290 +2311,299 @@ HdCyclesRenderParam::SetViewport(int w, int h)
 
     m_aovBindingsNeedValidation = true;
 
+    _ResetRenderStats();
     m_cyclesSession->reset(m_bufferParams, m_cyclesSession->params.samples);
+    m_cyclesScene->mutex.unlock();
+}
+
+bool
+HdCyclesRenderParam::SetDataWindow(const GfVec4f& a_dataWindowNDC)
+{
+    if (a_dataWindowNDC == m_dataWindowNDC)
+        return false;
+
+    m_dataWindowNDC = a_dataWindowNDC;
+
+    // Picked up by the reset of the next CommitResources
+    if (m_cyclesSession)
+        _UpdateBufferParams();
+
+    return true;
+}
+
+void
+HdCyclesRenderParam::_UpdateBufferParams()
+{
+    m_bufferParams.full_width  = m_width;
+    m_bufferParams.full_height = m_height;
+
+    // The camera and AOVs stay at full size, Cycles offsets the tiles of the
+    // region by full_x and full_y
+    const float xmin = ccl::clamp(m_dataWindowNDC[0], 0.0f, 1.0f);
+    const float ymin = ccl::clamp(m_dataWindowNDC[1], 0.0f, 1.0f);
+    const float xmax = ccl::clamp(m_dataWindowNDC[2], 0.0f, 1.0f);
+    const float ymax = ccl::clamp(m_dataWindowNDC[3], 0.0f, 1.0f);
+
+    const int x0 = static_cast<int>(std::floor(xmin * m_width));
+    const int y0 = static_cast<int>(std::floor(ymin * m_height));
+    const int x1 = static_cast<int>(std::ceil(xmax * m_width));
+    const int y1 = static_cast<int>(std::ceil(ymax * m_height));
+
+    if (x1 > x0 && y1 > y0) {
+        m_bufferParams.full_x = x0;
+        m_bufferParams.full_y = y0;
+        m_bufferParams.width  = x1 - x0;
+        m_bufferParams.height = y1 - y0;
+    } else {
+        // Empty or inverted windows render the full image
+        m_bufferParams.full_x = 0;
+        m_bufferParams.full_y = 0;
+        m_bufferParams.width  = m_width;
+        m_bufferParams.height = m_height;
+    }
 }
 
 void
 HdCyclesRenderParam::DirectReset()
 {
+    _ResetRenderStats();
     m_cyclesSession->reset(m_bufferParams, m_cyclesSession->params.samples);
 }
 
-void
-HdCyclesRenderParam::AddLight(ccl::Light* a_light)
+namespace {
+
+/**
+ * @brief Compact removed nodes out of a scene node list and append new ones
+ * Nodes added and removed within the same batch never reach the scene.
+ * Removed nodes are owned by the render param and deleted here.
+ * 
+ * @return Returns true if anything was queued
+ */
+template<typename T>
+bool
+_ApplyNodeEdits(ccl::vector<T*>& a_nodes, std::vector<T*>& a_added,
+                std::vector<T*>& a_removed)
 {
-    if (!m_cyclesScene) {
-        TF_WARN("Couldn't add light to scene. Scene is null.");
-        return;
-    }
+    if (a_added.empty() && a_removed.empty())
+        return false;
 
-    m_lightsUpdated = true;
+    if (!a_removed.empty()) {
+        std::unordered_set<T*> removed(a_removed.begin(), a_removed.end());
+        auto isRemoved = [&removed](T* node) {
+            return removed.find(node) != removed.end();
+        };
 
-    m_cyclesScene->mutex.lock();
-    m_cyclesScene->lights.push_back(a_light);
-    m_cyclesScene->mutex.unlock();
+        a_added.erase(std::remove_if(a_added.begin(), a_added.end(),
+                                     isRemoved),
+                      a_added.end());
 
-    if (a_light->type == ccl::LIGHT_BACKGROUND) {
-        m_hasDomeLight = true;
-    }
+        // A single stable pass, the surviving nodes keep their order and ids
+        a_nodes.erase(std::remove_if(a_nodes.begin(), a_nodes.end(),
+                                     isRemoved),
+                      a_nodes.end());
 
-    if (m_cyclesScene->lights.size() > 0) {
-        if (!m_hasDomeLight)
-            SetBackgroundShader(nullptr, false);
-    } else {
-        SetBackgroundShader(nullptr, true);
+        for (T* node : removed)
+            delete node;
+
+        a_removed.clear();
     }
+
+    a_nodes.insert(a_nodes.end(), a_added.begin(), a_added.end());
+    a_added.clear();
+
+    return true;
 }
 
-void
-HdCyclesRenderParam::AddObject(ccl::Object* a_object)
+}  // namespace
+
+bool
+HdCyclesRenderParam::_ApplySceneEdits()
 {
-    if (!m_cyclesScene) {
-        TF_WARN("Couldn't add object to scene. Scene is null.");
-        return;
-    }
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+
+    if (!m_hasSceneEdits)
+        return false;
 
-    m_objectsUpdated = true;
+    uint32_t changes = NoChanges;
 
-    m_cyclesScene->objects.push_back(a_object);
+    if (_ApplyNodeEdits(m_cyclesScene->objects, m_addedObjects,
+                        m_removedObjects))
+        changes |= TopologyChanged;
 
-    Interrupt();
+    if (_ApplyNodeEdits(m_cyclesScene->geometry, m_addedGeometry,
+                        m_removedGeometry))
+        changes |= TopologyChanged;
+
+    if (_ApplyNodeEdits(m_cyclesScene->shaders, m_addedShaders,
+                        m_removedShaders))
+        changes |= ShaderChanged;
+
+    if (_ApplyNodeEdits(m_cyclesScene->lights, m_addedLights,
+                        m_removedLights)) {
+        changes |= LightChanged;
+
+        // The shader of a removed dome light was just deleted
+        _UpdateBackgroundShader();
+    }
+
+    MarkChanged(changes);
+
+    m_hasSceneEdits = false;
+    return true;
 }
 
 void
-HdCyclesRenderParam::AddGeometry(ccl::Geometry* a_geometry)
+HdCyclesRenderParam::AddLight(ccl::Light* a_light)
 {
     if (!m_cyclesScene) {
-        TF_WARN("Couldn't add geometry to scene. Scene is null.");
+        TF_WARN("Couldn't add light to scene. Scene is null.");
         return;
     }
 
-    m_geometryUpdated = true;
-
-    m_cyclesScene->mutex.lock();
-    m_cyclesScene->geometry.push_back(a_geometry);
-    m_cyclesScene->mutex.unlock();
-
-    Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_addedLights.push_back(a_light);
+    m_hasSceneEdits = true;
 }
 
 void
-HdCyclesRenderParam::AddMesh(ccl::Mesh* a_mesh)
+HdCyclesRenderParam::AddObject(ccl::Object* a_object)
 {
     if (!m_cyclesScene) {
-        TF_WARN("Couldn't add geometry to scene. Scene is null.");
+        TF_WARN("Couldn't add object to scene. Scene is null.");
         return;
     }
 
-    m_meshUpdated = true;
-
-    m_cyclesScene->mutex.lock();
-    m_cyclesScene->geometry.push_back(a_mesh);
-    m_cyclesScene->mutex.unlock();
-
-    Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_addedObjects.push_back(a_object);
+    m_hasSceneEdits = true;
 }
 
 void
-HdCyclesRenderParam::AddCurve(ccl::Geometry* a_curve)
+HdCyclesRenderParam::AddGeometry(ccl::Geometry* a_geometry)
 {
     if (!m_cyclesScene) {
         TF_WARN("Couldn't add geometry to scene. Scene is null.");
         return;
     }
 
-    m_curveUpdated = true;
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_addedGeometry.push_back(a_geometry);
+    m_hasSceneEdits = true;
+}
 
-    m_cyclesScene->mutex.lock();
-    m_cyclesScene->geometry.push_back(a_curve);
-    m_cyclesScene->mutex.unlock();
+void
+HdCyclesRenderParam::AddMesh(ccl::Mesh* a_mesh)
+{
+    AddGeometry(a_mesh);
+}
 
-    Interrupt();
+void
+HdCyclesRenderParam::AddCurve(ccl::Geometry* a_curve)
+{
+    AddGeometry(a_curve);
 }
 
 void
 HdCyclesRenderParam::AddShader(ccl::Shader* a_shader)
 {
     if (!m_cyclesScene) {
-        TF_WARN("Couldn't add geometry to scene. Scene is null.");
+        TF_WARN("Couldn't add shader to scene. Scene is null.");
         return;
     }
 
-    m_shadersUpdated = true;
-
-    m_cyclesScene->shaders.push_back(a_shader);
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_addedShaders.push_back(a_shader);
+    m_hasSceneEdits = true;
 }
 
 void
 HdCyclesRenderParam::RemoveObject(ccl::Object* a_object)
 {
-    for (ccl::vector<ccl::Object*>::iterator it = m_cyclesScene->objects.begin();
-         it != m_cyclesScene->objects.end();) {
-        if (a_object == *it) {
-            m_cyclesScene->mutex.lock();
-            it = m_cyclesScene->objects.erase(it);
-
-            m_objectsUpdated = true;
-            m_cyclesScene->mutex.unlock();
-            break;
-        } else {
-            ++it;
-        }
-    }
-
-    if (m_objectsUpdated)
-        Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_removedObjects.push_back(a_object);
+    m_hasSceneEdits = true;
 }
 
 void
 HdCyclesRenderParam::RemoveLight(ccl::Light* a_light)
 {
-    if (a_light->type == ccl::LIGHT_BACKGROUND) {
-        m_hasDomeLight = false;
-    }
-
-    for (ccl::vector<ccl::Light*>::iterator it = m_cyclesScene->lights.begin();
-         it != m_cyclesScene->lights.end();) {
-        if (a_light == *it) {
-            m_cyclesScene->mutex.lock();
-
-            it = m_cyclesScene->lights.erase(it);
-
-            m_lightsUpdated = true;
-
-            m_cyclesScene->mutex.unlock();
-
-            break;
-        } else {
-            ++it;
-        }
-    }
-
-    if (m_cyclesScene->lights.size() > 0) {
-        if (!m_hasDomeLight)
-            SetBackgroundShader(nullptr, false);
-    } else {
-        SetBackgroundShader(nullptr, true);
-    }
-
-    if (m_lightsUpdated)
-        Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_removedLights.push_back(a_light);
+    m_hasSceneEdits = true;
 }
 
 void
 HdCyclesRenderParam::RemoveMesh(ccl::Mesh* a_mesh)
 {
-    for (ccl::vector<ccl::Geometry*>::iterator it
-         = m_cyclesScene->geometry.begin();
-         it != m_cyclesScene->geometry.end();) {
-        if (a_mesh == *it) {
-            m_cyclesScene->mutex.lock();
-
-            it = m_cyclesScene->geometry.erase(it);
-
-            m_meshUpdated = true;
-
-            m_cyclesScene->mutex.unlock();
-
-            break;
-        } else {
-            ++it;
-        }
-    }
-
-    if (m_geometryUpdated)
-        Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_removedGeometry.push_back(a_mesh);
+    m_hasSceneEdits = true;
 }
 
 void
-HdCyclesRenderParam::RemoveCurve(ccl::Hair* a_hair)
+HdCyclesRenderParam::RemoveCurve(ccl::Geometry* a_curve)
 {
-    for (ccl::vector<ccl::Geometry*>::iterator it
-         = m_cyclesScene->geometry.begin();
-         it != m_cyclesScene->geometry.end();) {
-        if (a_hair == *it) {
-            m_cyclesScene->mutex.lock();
-
-            it = m_cyclesScene->geometry.erase(it);
-
-            m_curveUpdated = true;
-
-            m_cyclesScene->mutex.unlock();
-
-            break;
-        } else {
-            ++it;
-        }
-    }
-
-    if (m_geometryUpdated)
-        Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_removedGeometry.push_back(a_curve);
+    m_hasSceneEdits = true;
 }
 
 void
 HdCyclesRenderParam::RemoveShader(ccl::Shader* a_shader)
 {
-    for (ccl::vector<ccl::Shader*>::iterator it = m_cyclesScene->shaders.begin();
-         it != m_cyclesScene->shaders.end();) {
-        if (a_shader == *it) {
-            m_cyclesScene->mutex.lock();
-
-            it = m_cyclesScene->shaders.erase(it);
-
-            m_shadersUpdated = true;
-
-            m_cyclesScene->mutex.unlock();
-
-            break;
-        } else {
-            ++it;
-        }
-    }
-
-    if (m_shadersUpdated)
-        Interrupt();
+    std::lock_guard<std::mutex> lock(m_sceneEditsMutex);
+    m_removedShaders.push_back(a_shader);
+    m_hasSceneEdits = true;
 }
 
 VtDictionary
 HdCyclesRenderParam::GetRenderStats() const
 {
-    // Currently, collect_statistics errors seemingly during render,
-    // we probably need to only access these when the render is complete
-    // however this codeflow is currently undefined...
-
-    //ccl::RenderStats stats;
-    //m_cyclesSession->collect_statistics(&stats);
+    // Husk and Solaris query from their own threads at any time, only the
+    // snapshot is read here and never the live session or scene.
+    RenderStats stats;
+    {
+        std::lock_guard<std::mutex> lock(m_statsMutex);
+        stats = m_renderStats;
+    }
 
     return {
         { "hdcycles:version", VtValue(HD_CYCLES_VERSION) },
 
         // - Cycles specific
 
-        // These error out currently, kept for future reference
-        /*{ "hdcycles:geometry:total_memory",
-          VtValue(ccl::string_human_readable_size(stats.mesh.geometry.total_size)
-                      .c_str()) },*/
-        /*{ "hdcycles:textures:total_memory",
-          VtValue(
-              ccl::string_human_readable_size(stats.image.textures.total_size)
-                  .c_str()) },*/
-        { "hdcycles:scene:num_objects", VtValue(m_cyclesScene->objects.size()) },
-        { "hdcycles:scene:num_shaders", VtValue(m_cyclesScene->shaders.size()) },
+        { "hdcycles:geometry:total_memory",
+          VtValue(ccl::string_human_readable_size(stats.geometryMemory)) },
+        { "hdcycles:textures:total_memory",
+          VtValue(ccl::string_human_readable_size(stats.textureMemory)) },
+        { "hdcycles:device:memory_used",
+          VtValue(ccl::string_human_readable_size(stats.deviceMemory)) },
+        { "hdcycles:device:memory_peak",
+          VtValue(ccl::string_human_readable_size(stats.deviceMemoryPeak)) },
+        { "hdcycles:scene:num_objects", VtValue(stats.numObjects) },
+        { "hdcycles:scene:num_shaders", VtValue(stats.numShaders) },
+        { "hdcycles:samples_per_second", VtValue(stats.samplesPerSecond) },
+        { "hdcycles:pixel_samples", VtValue(stats.pixelSamples) },
+        { "hdcycles:pixel_samples_per_second",
+          VtValue(stats.pixelSamplesPerSecond) },
+        { "hdcycles:time:sync", VtValue(stats.syncTime) },
+        { "hdcycles:time:device_update",
+          VtValue(std::max(stats.deviceUpdateTime, 0.0)) },
+        { "hdcycles:time:path_trace", VtValue(stats.pathTraceTime) },
+        { "hdcycles:time:remaining", VtValue(stats.eta) },
+        { "hdcycles:tiles:completed", VtValue(stats.completedTiles) },
 
         // - Solaris, husk specific
 
-        // Currently these don't update properly. It is unclear if we need to tag renderstats as
-        // dynamic. Maybe our VtValues need to live longer?
-
         { "rendererName", VtValue("Cycles") },
         { "rendererVersion", VtValue(HD_CYCLES_VERSION) },
-        { "percentDone", VtValue(m_renderPercent) },
-        { "fractionDone", VtValue(m_renderProgress) },
-        { "lightCounts", VtValue(m_cyclesScene->lights.size()) },
-        { "totalClockTime", VtValue(m_totalTime) },
-        { "cameraRays", VtValue(0) },
-        { "numCompletedSamples", VtValue(0) }
-
+        { "percentDone",
+          VtValue(static_cast<int>(floor(stats.progress * 100))) },
+        { "fractionDone", VtValue(stats.progress) },
+        { "lightCounts", VtValue(stats.numLights) },
+        { "totalClockTime", VtValue(stats.totalTime) },
+        { "cameraRays", VtValue(stats.pixelSamples) },
+        { "numCompletedSamples", VtValue(stats.completedSamples) }
     };
 }
 
@@ -28,9 +28,19 @@
 #include <render/session.h>
 #include <render/tile.h>
 
+#include <pxr/base/gf/vec4f.h>
 #include <pxr/imaging/hd/renderDelegate.h>
 #include <pxr/pxr.h>
 
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace ccl {
 class Session;
 class Scene;
@@ -41,12 +51,42 @@ class Shader;
 
 PXR_NAMESPACE_OPEN_SCOPE
 
+class HdCyclesRenderBuffer;
+
+/**
+ * @brief Interface for prims that convert their data into private staging
+ * storage during Sync, without holding the Cycles scene mutex.
+ * 
+ * Staged prims are published into the Cycles scene by
+ * HdCyclesRenderParam::CommitResources in a single critical section.
+ * 
+ * Meshes and materials stage all of their data. Curves only stage the swap
+ * of their geometry, they edit the scene nodes in Sync like points, volumes
+ * and lights do, under HdCyclesRenderParam::LockScene.
+ * 
+ */
+class HdCyclesStagedPrim {
+public:
+    virtual ~HdCyclesStagedPrim() = default;
+
+    /**
+     * @brief Publish the staged data into the Cycles scene
+     * Called from CommitResources with the scene mutex held.
+     * 
+     * @param scene Cycles scene to publish into
+     */
+    virtual void CommitStaged(ccl::Scene* scene) = 0;
+};
+
 /**
  * @brief The proposed main interface to the cycles session and scene
  * Very much under construction.
  * 
  */
 class HdCyclesRenderParam : public HdRenderParam {
+    // Forwards the session callbacks to the owning render param
+    friend class HdCyclesSessionPool;
+
 public:
     /**
     * @brief Construct a new HdCycles Render Param object
@@ -84,12 +124,24 @@ public:
     void RestartRender();
 
     /**
-     * @brief Restarts the current cycles render
+     * @brief Request a restart of the current cycles render
+     * Thread safe. Requests are coalesced and the reset happens in
+     * CommitResources once the interrupt window or latency budget elapsed.
      * 
      */
     HDCYCLES_API
     void Interrupt(bool a_forceUpdate = false);
 
+    /**
+     * @brief Request a restart after the active camera changed
+     * Coalesced with Interrupt. If nothing else requested a restart by the
+     * next CommitResources, sampling restarts with the new camera without
+     * tagging the scene managers or rebuilding the background.
+     * 
+     */
+    HDCYCLES_API
+    void InterruptCamera();
+
     /**
      * @brief Initialize cycles renderer
      * Core first time initialization of HdCycles
@@ -117,17 +169,21 @@ public:
     HDCYCLES_API
     bool IsConverged();
 
+    /**
+     * @brief Generation of the session output, incremented by every session
+     * progress update. The display and session buffers only change between
+     * two updates, so an unchanged version has nothing new to blit.
+     */
+    uint64_t GetDisplayVersion() const { return m_displayVersion.load(); }
+
     /**
      * @brief Key access point to set a HdCycles render setting via key and value
-     * Handles SessionParams, SceneParams, Integrator, Film, and Background intelligently.
-     * 
-     * This has some inherent performance overheads (runs multiple times, unecessary)
-     * however for now, this works the most clearly due to Cycles restrictions
+     * Dispatches through the render setting registry to the SessionParams,
+     * SceneParams, Integrator, Film or Background setter of the key.
      * 
      * @param key 
      * @param value 
-     * @return true 
-     * @return false 
+     * @return Returns true if the setting changed and the render needs a reset
      */
     bool SetRenderSetting(const TfToken& key, const VtValue& valuekey);
 
@@ -151,7 +207,52 @@ protected:
      */
     void _SessionUpdateCallback();
 
+    /**
+     * @brief Refresh the sample and timing statistics from the session
+     * progress. Called from the session thread.
+     * 
+     */
+    void _UpdateRenderStats();
+
+    /**
+     * @brief Snapshot the scene and device memory statistics
+     * Only collected once the session finished updating the device, image
+     * memory isn't allocated before that.
+     * 
+     */
+    void _UpdateMemoryStats();
+
+    /**
+     * @brief Restart the progressive statistics when the session is reset
+     * 
+     */
+    void _ResetRenderStats();
+
+    /**
+     * @brief Time the progressive passes of the session, a pass is done when
+     * the resolution divider drops. Called from the session thread.
+     * 
+     */
+    void _MeasureProgressivePass();
+
+    /**
+     * @brief Pick the start resolution of the session so its first pass
+     * fits the target frame time, from the measured cost of a pixel
+     * Cycles only takes it when a session is created, call it before the
+     * session is acquired.
+     * 
+     */
+    void _UpdateStartResolution();
+
+    /**
+     * @brief Restart sampling after a camera only edit
+     * 
+     * @return false if the session holds the scene mutex, nothing was reset
+     */
+    bool _ResetCamera();
+
     void _WriteRenderTile(ccl::RenderTile& rtile);
+
     void _UpdateRenderTile(ccl::RenderTile& rtile, bool highlight);
 
 public:
@@ -161,6 +262,49 @@ public:
         Y = 1,
     };
 
+    // Categories of scene changes, CyclesReset maps each to the smallest
+    // Cycles update that covers it.
+    enum ChangeBits : uint32_t {
+        NoChanges         = 0,
+        TransformChanged  = 1 << 0,  // Object transforms
+        VisibilityChanged = 1 << 1,  // Object visibility and flags
+        ShaderChanged     = 1 << 2,  // Shader parameters and graphs
+        GeometryChanged   = 1 << 3,  // Geometry data, same topology
+        TopologyChanged   = 1 << 4,  // New geometry or scene membership
+        LightChanged      = 1 << 5,  // Lights and emission
+        SceneChanged      = 1 << 6,  // Scene parameters, BVH build settings
+    };
+
+    /**
+     * @brief Record scene changes to be handled by the next reset
+     * Thread safe.
+     * 
+     * @param a_changes Combination of ChangeBits
+     */
+    void MarkChanged(uint32_t a_changes);
+
+    // Cycles objects a render setting applies to, in the order Initialize
+    // creates and configures them.
+    enum SettingCategory : uint8_t {
+        SettingDelegate = 0,
+        SettingSession,
+        SettingScene,
+        SettingFilm,
+        SettingIntegrator,
+        SettingBackground,
+        SettingCategoryCount,
+    };
+
+    /**
+     * @brief Entry of the render setting registry
+     * apply returns true if the value had the expected type and was written.
+     * 
+     */
+    struct RenderSetting {
+        SettingCategory category;
+        std::function<bool(HdCyclesRenderParam&, const VtValue&)> apply;
+    };
+
     /**
      * @brief Cycles general reset
      * 
@@ -170,7 +314,7 @@ public:
 
     /**
      * @brief Set "viewport" based on width and height
-     * TODO: Add support for render regions
+     * Resets the session at the new size, no Interrupt is needed.
      * 
      * @param w Width of new render
      * @param h Height of new render
@@ -178,19 +322,21 @@ public:
     void SetViewport(int w, int h);
 
     /**
-     * @brief Slightly hacky workaround to directly reset the session
+     * @brief Set the render region, as UsdRenderSettings dataWindowNDC
+     * Only the region is allocated and traced, the full size is kept for
+     * the camera and the AOVs.
      * 
+     * @param a_dataWindowNDC (xmin, ymin, xmax, ymax), (0, 0, 1, 1) renders
+     * the full image
+     * @return Returns true if the region changed
      */
-    void DirectReset();
+    bool SetDataWindow(const GfVec4f& a_dataWindowNDC);
 
     /**
-     * @brief Helper to set the background shader 
+     * @brief Slightly hacky workaround to directly reset the session
      * 
-     * @param a_shader Shader to use
-     * @param a_emissive Should the default bg be emissive
      */
-    void SetBackgroundShader(ccl::Shader* a_shader = nullptr,
-                             bool a_emissive       = true);
+    void DirectReset();
 
     /* ======= Cycles Settings ======= */
 
@@ -267,14 +413,18 @@ public:
     void AddObject(ccl::Object* a_object);
 
     /**
-     * @brief Remove hair geometry from cycles scene
+     * @brief Remove curve geometry from cycles scene
+     * Takes ownership, the geometry is deleted once it has been removed
+     * in the next CommitResources.
      * 
-     * @param a_hair Hair to remove
+     * @param a_curve Hair or ribbon mesh to remove
      */
-    void RemoveCurve(ccl::Hair* a_hair);
+    void RemoveCurve(ccl::Geometry* a_curve);
 
     /**
      * @brief Remove light from cycles scene
+     * Takes ownership, the light is deleted once it has been removed
+     * in the next CommitResources.
      * 
      * @param a_light Light to remove
      */
@@ -282,6 +432,8 @@ public:
 
     /**
      * @brief Remove shader from cycles scene
+     * Takes ownership, the shader is deleted once it has been removed
+     * in the next CommitResources.
      * 
      * @param a_shader Shader to remove
      */
@@ -289,6 +441,8 @@ public:
 
     /**
      * @brief Remove mesh geometry from cycles scene
+     * Takes ownership, the mesh is deleted once it has been removed
+     * in the next CommitResources.
      * 
      * @param a_mesh Mesh to remove
      */
@@ -296,6 +450,8 @@ public:
 
     /**
      * @brief Remove object from cycles scene
+     * Takes ownership, the object is deleted once it has been removed
+     * in the next CommitResources.
      * 
      * @param a_object Object to remove
      */
@@ -317,37 +473,90 @@ private:
     bool _CreateScene();
 
     void _UpdateDelegateFromConfig(bool a_forceInit = false);
-    void
-    _UpdateDelegateFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleDelegateRenderSetting(const TfToken& key, const VtValue& value);
-
     void _UpdateSessionFromConfig(bool a_forceInit = false);
-    void
-    _UpdateSessionFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleSessionRenderSetting(const TfToken& key, const VtValue& value);
-
     void _UpdateSceneFromConfig(bool a_forceInit = false);
-    void _UpdateSceneFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleSceneRenderSetting(const TfToken& key, const VtValue& value);
-
     void _UpdateFilmFromConfig(bool a_forceInit = false);
-    void _UpdateFilmFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleFilmRenderSetting(const TfToken& key, const VtValue& value);
-
     void _UpdateIntegratorFromConfig(bool a_forceInit = false);
-    void
-    _UpdateIntegratorFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleIntegratorRenderSetting(const TfToken& key,
-                                        const VtValue& value);
-
     void _UpdateBackgroundFromConfig(bool a_forceInit = false);
-    void
-    _UpdateBackgroundFromRenderSettings(HdRenderSettingsMap const& settingsMap);
-    bool _HandleBackgroundRenderSetting(const TfToken& key,
-                                        const VtValue& value);
+
+    using RenderSettingRegistry
+        = std::unordered_map<TfToken, RenderSetting, TfToken::HashFunctor>;
+
+    /**
+     * @brief Registry of every supported render setting, built once
+     * 
+     * @return Map of setting token to its category and typed setter
+     */
+    static const RenderSettingRegistry& _GetRenderSettingRegistry();
+
+    /**
+     * @brief Apply a single render setting if its value changed
+     * 
+     * @return Returns true if the setting was applied
+     */
+    bool _ApplyRenderSetting(const TfToken& a_key,
+                             const RenderSetting& a_setting,
+                             const VtValue& a_value);
+
+    /**
+     * @brief Tag the Cycles nodes of the given setting categories for update
+     * 
+     * @param a_categories Bitmask of (1 << SettingCategory)
+     */
+    void _TagRenderSettingCategories(uint32_t a_categories);
+
+    ccl::SessionParams* _GetSessionParams();
+    ccl::SceneParams* _GetSceneParams();
 
     void _HandlePasses();
 
+    /**
+     * @brief Hand the denoising settings to the session
+     * Session::set_denoising takes the buffers mutex, which the session
+     * thread holds before it takes the scene mutex. Never call this with the
+     * scene mutex held, and only while the session is paused or not started.
+     * 
+     */
+    void _ApplyDenoising();
+
+    /**
+     * @brief Pause the session and apply the denoising settings if they
+     * changed since they were last applied, the reset raised resumes it
+     * 
+     */
+    void _UpdateDenoising();
+
+    /**
+     * @brief Fit the buffer to the data window of the full resolution
+     * 
+     */
+    void _UpdateBufferParams();
+
+    /**
+     * @brief Check if pending interrupts should be turned into a reset now
+     * 
+     * @return Returns true if there is no pending interrupt, or if the
+     * interrupt window or the latency budget elapsed
+     */
+    bool _IsInterruptDue();
+
+    /**
+     * @brief Bind the dome light shader as the world, or the default
+     * background when there is none. Its graph is only rebuilt when the
+     * scene gains its first light or loses its last one.
+     * Must be called with the scene mutex held.
+     * 
+     */
+    void _UpdateBackgroundShader();
+
+    /**
+     * @brief Apply all queued scene additions and removals
+     * Must be called with the scene mutex held.
+     * 
+     * @return Returns true if the scene changed
+     */
+    bool _ApplySceneEdits();
+
     /**
      * @brief Initialize member values based on config
      * TODO: Refactor this
@@ -365,38 +574,182 @@ private:
     int m_renderPercent;
     float m_renderProgress;
 
+    std::atomic<uint64_t> m_displayVersion;
+
     double m_totalTime;
     double m_renderTime;
 
+    // Statistics reported by GetRenderStats
+    struct RenderStats {
+        float progress;
+        int completedSamples;
+        int totalSamples;
+        uint64_t pixelSamples;
+        uint64_t numPixels;
+        double samplesPerSecond;
+        double pixelSamplesPerSecond;
+        double eta;
+
+        // Seconds spent committing the last edits, updating the device
+        // after the last reset and path tracing since then
+        double syncTime;
+        double deviceUpdateTime;
+        double pathTraceTime;
+        double totalTime;
+
+        size_t geometryMemory;
+        size_t textureMemory;
+        size_t deviceMemory;
+        size_t deviceMemoryPeak;
+        size_t numObjects;
+        size_t numShaders;
+        size_t numLights;
+        bool memoryStale;
+
+        int completedTiles;
+
+        std::chrono::steady_clock::time_point resetTime;
+    };
+
+    // Written by the session thread and CommitResources, read by
+    // GetRenderStats from any thread
+    mutable std::mutex m_statsMutex;
+    RenderStats m_renderStats;
+
     ccl::DeviceType m_deviceType;
     std::string m_deviceName;
 
     bool m_useTiledRendering;
 
+    bool m_sequenceMode;
+
+    // Publish staged prims without pausing the session, and without
+    // waiting on the scene mutex while the device is being updated
+    bool m_overlapSync;
+
+    // Progressive color comes from the combined pass instead of the display
+    bool m_displayBufferFloat;
+
+    // Denoising settings the session was last given
+    ccl::DenoiseParams m_sessionDenoising;
+
+    // Seconds since the last reset after which the render is done, 0 if
+    // only the sample count ends it
+    double m_timeLimit;
+
+    // Seconds the first progressive pass should take, 0 if the start
+    // resolution is fixed
+    double m_targetFrameTime;
+
+    // Resolution divider of the pass being timed, session thread only
+    int m_passDivider;
+    std::chrono::steady_clock::time_point m_passStartTime;
+
     bool m_aovBindingsNeedValidation;
 
     int m_width;
     int m_height;
 
-    bool m_objectsUpdated;
-    bool m_geometryUpdated;
-    bool m_curveUpdated;
-    bool m_meshUpdated;
-    bool m_lightsUpdated;
-    bool m_shadersUpdated;
+    GfVec4f m_dataWindowNDC;
+
+    std::atomic<uint32_t> m_pendingChanges;
+
+    // Last applied value of each render setting
+    std::unordered_map<TfToken, VtValue, TfToken::HashFunctor> m_renderSettings;
 
     bool m_shouldUpdate;
 
-    bool m_hasDomeLight;
+    // Only the camera changed since the last reset, guarded by
+    // m_interruptMutex
+    bool m_cameraChanged;
+
+    // Interrupt coalescing, guarded by m_interruptMutex
+    std::mutex m_interruptMutex;
+    std::chrono::steady_clock::time_point m_firstInterruptTime;
+    std::chrono::steady_clock::time_point m_lastInterruptTime;
+    std::chrono::milliseconds m_interruptWindow;
+    std::chrono::milliseconds m_interruptLatency;
+
+    // World shader of scenes without a dome light, emissive only while
+    // the scene has no lights
+    ccl::Shader* m_defaultBackground;
+    bool m_defaultBackgroundEmissive;
 
     bool m_useSquareSamples;
 
+    // Sampling pattern from the render settings, adaptive sampling overrides
+    // it with PMJ while it is enabled
+    ccl::SamplingPattern m_samplingPattern;
+
     UpAxis m_upAxis;
 
 public:
     const bool& IsTiledRender() const { return m_useTiledRendering; }
 
+    /**
+     * @brief Buffer of the current render, full_x and full_y place the
+     * render region in the full size image
+     * 
+     */
+    const ccl::BufferParams& GetBufferParams() const { return m_bufferParams; }
+
+    /**
+     * @brief Prims keep content hashes of their last conversion and skip
+     * updates that don't change them, so only animated prims are converted
+     * again on a new frame
+     * 
+     */
+    bool IsSequenceMode() const { return m_sequenceMode; }
+
+    /**
+     * @brief Progressive color is read from the combined pass as
+     * HdFormatFloat32Vec4, normalized by the sample count of each pixel,
+     * rather than from the byte or half display buffer
+     * 
+     * The combined pass is read on the session thread with the other
+     * passes, at the display update rate. BlitSessionPasses hands it to a
+     * float color AOV of the same size by exchanging it with the back
+     * buffer, without a copy.
+     * 
+     */
+    bool IsDisplayBufferFloat() const
+    {
+        // The session only writes the denoised image to the display buffer
+        return m_displayBufferFloat && !m_useTiledRendering
+               && !(m_cyclesSession && m_cyclesSession->params.denoising.use);
+    }
+
+    /**
+     * @brief Publish all staged prims and reset the session if needed
+     * 
+     */
     void CommitResources();
+
+    /**
+     * @brief Queue a prim for publishing in the next CommitResources
+     * Thread safe, intended to be called from Sync.
+     * 
+     * @param a_prim Prim with staged data
+     */
+    void StagePrim(HdCyclesStagedPrim* a_prim);
+
+    /**
+     * @brief Remove a prim from the staging queue
+     * Must be called before a staged prim is destroyed.
+     * 
+     * @param a_prim Prim to remove
+     */
+    void UnstagePrim(HdCyclesStagedPrim* a_prim);
+
+    /**
+     * @brief Lock the scene for a prim that edits the live scene in Sync
+     * Serializes the Sync of such prims. The session isn't interrupted, a
+     * prim that changed the scene calls MarkChanged and Interrupt itself.
+     * 
+     * @return Lock on the scene mutex
+     */
+    std::unique_lock<ccl::thread_mutex> LockScene();
+
     /**
      * @brief Get the active Cycles Session 
      * 
@@ -430,14 +783,144 @@ private:
     ccl::Session* m_cyclesSession;
     ccl::Scene* m_cyclesScene;
 
+    // The session came from the pool with a scene to repopulate
+    bool m_sessionIsWarm;
+
+    std::mutex m_stagedPrimsMutex;
+    std::vector<HdCyclesStagedPrim*> m_stagedPrims;
+
+    // Scene membership edits, applied in one pass by _ApplySceneEdits
+    std::mutex m_sceneEditsMutex;
+    bool m_hasSceneEdits = false;
+    std::vector<ccl::Object*> m_addedObjects;
+    std::vector<ccl::Object*> m_removedObjects;
+    std::vector<ccl::Geometry*> m_addedGeometry;
+    std::vector<ccl::Geometry*> m_removedGeometry;
+    std::vector<ccl::Shader*> m_addedShaders;
+    std::vector<ccl::Shader*> m_removedShaders;
+    std::vector<ccl::Light*> m_addedLights;
+    std::vector<ccl::Light*> m_removedLights;
 
     HdRenderPassAovBindingVector m_aovs;
 
+    // Render buffers bound to each pass, built when the bindings change so
+    // tiles don't look passes up by AOV name
+    struct PassBinding {
+        size_t aov;  // Index in DefaultAovs
+        std::vector<HdCyclesRenderBuffer*> buffers;
+    };
+    struct PassBindings {
+        uint64_t version = 0;
+        std::vector<PassBinding> bindings;
+    };
+
+    // Never modified once published. SetAovBindings swaps in a new
+    // snapshot, the tile callbacks and blits keep the one they started
+    // with. m_aovsMutex only guards the pointer.
+    std::mutex m_aovsMutex;
+    std::shared_ptr<const PassBindings> m_passBindings;
+
+    /**
+     * @brief Current pass bindings snapshot
+     * 
+     */
+    std::shared_ptr<const PassBindings> _GetPassBindings();
+
+    // A finished render tile, its passes are read in the tile callback as
+    // Cycles reuses the tile buffers once it returns. A record is the
+    // scratch of the thread reading it, then goes back to m_freeTiles with
+    // its pass storage once blitted.
+    struct CompletedTile {
+        int x;
+        int y;
+        int width;
+        int height;
+        uint64_t bindingsVersion;
+
+        // One per pass binding, in the format of its AOV
+        std::vector<std::vector<uint8_t>> passes;
+    };
+
+    // Filled by the tile callbacks and drained on the Hydra thread. Records
+    // and lists only grow to the tiles in flight and the largest tile, a
+    // steady render reads and blits its tiles without allocating.
+    std::mutex m_tilesMutex;
+    std::vector<std::unique_ptr<CompletedTile>> m_completedTiles;
+    std::vector<std::unique_ptr<CompletedTile>> m_freeTiles;
+
+    // Tiles taken by BlitCompletedTiles, Hydra thread only
+    std::vector<std::unique_ptr<CompletedTile>> m_blitTiles;
+
+    // Passes of the session buffers after the latest progressive sample,
+    // read on the session thread and taken by BlitSessionPasses
+    std::mutex m_sessionPassesMutex;
+    std::unique_ptr<CompletedTile> m_sessionPasses;
+
+    // Last time the session passes were read, session thread only
+    std::chrono::steady_clock::time_point m_sessionPassesReadTime;
+
+    /**
+     * @brief Read each bound pass of the buffers once, called from the
+     * session thread while Cycles can't reset the buffers
+     * 
+     * @param a_x Offset of the buffers in the full image
+     * @param a_y Offset of the buffers in the full image
+     * @param a_sample Number of samples in the buffers
+     * @param a_skipColor Leave the color AOV to the display buffer
+     * @return Returns the passes, in a record of m_freeTiles if possible
+     */
+    std::unique_ptr<CompletedTile> _ReadTile(ccl::RenderBuffers* a_buffers,
+                                             int a_x, int a_y, int a_sample,
+                                             bool a_skipColor);
+
+    /**
+     * @brief Hand a blitted record back for reuse
+     * 
+     */
+    void _RecycleTile(std::unique_ptr<CompletedTile> a_tile);
+
+    /**
+     * @brief Read the session buffers once a progressive sample of the
+     * whole image is done, replacing the passes not blitted yet
+     * Limited to one read per progressive_update_timeout, besides the first
+     * and last sample of a render.
+     * 
+     */
+    void _ReadSessionPasses(ccl::RenderTile& rtile);
+
+    /**
+     * @brief Blit the passes of a tile to the buffers bound to them
+     * 
+     * @param a_bindings Bindings the tile was read with
+     */
+    void _BlitTile(const PassBindings& a_bindings, const CompletedTile& a_tile);
+
 public:
-    void SetAovBindings(HdRenderPassAovBindingVector const& a_aovs)
-    {
-        m_aovs = a_aovs;
-    }
+    /**
+     * @brief Bind AOVs to Cycles passes
+     * Buffers are reallocated with the passes of the bound AOVs.
+     * 
+     * @param a_aovs Bindings of the render pass
+     */
+    void SetAovBindings(HdRenderPassAovBindingVector const& a_aovs);
+
+    /**
+     * @brief Blit the passes of the session buffers to the bound AOVs
+     * Progressive rendering only, tiled rendering writes the tiles as they
+     * finish. The passes are read on the session thread while it samples,
+     * this blits the latest. A pass is exchanged with the back buffer of
+     * the last buffer bound to it when the format and size match. The color
+     * AOV comes from the display buffer unless IsDisplayBufferFloat.
+     * 
+     */
+    void BlitSessionPasses();
+
+    /**
+     * @brief Blit the tiles finished since the last call to the bound AOVs
+     * Tiled rendering only, called from the render pass on the Hydra thread.
+     * 
+     */
+    void BlitCompletedTiles();
 
     HdRenderPassAovBindingVector const& GetAovBindings() const
     {
@@ -20,6 +20,7 @@
 #include "renderPass.h"
 
 #include "camera.h"
+#include "config.h"
 #include "renderBuffer.h"
 #include "renderParam.h"
 #include "utils.h"
@@ -33,6 +34,8 @@
 #include <pxr/imaging/hd/camera.h>
 #include <pxr/imaging/hd/renderPassState.h>
 
+#include <algorithm>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
 // clang-format off
@@ -47,6 +50,8 @@ HdCyclesRenderPass::HdCyclesRenderPass(HdCyclesRenderDelegate* delegate,
                                        HdRprimCollection const& collection)
     : HdRenderPass(index, collection)
     , m_delegate(delegate)
+    , m_resizeDelay(std::max(
+          HdCyclesConfig::GetInstance().resize_delay.value, 0))
 {
 }
 
@@ -61,8 +66,10 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
 
     HdRenderPassAovBindingVector aovBindings = renderPassState->GetAovBindings();
 
-    if (renderParam->GetAovBindings() != aovBindings)
+    if (renderParam->GetAovBindings() != aovBindings) {
         renderParam->SetAovBindings(aovBindings);
+        m_displayVersion = 0;
+    }
 
     const auto vp = renderPassState->GetViewport();
 
@@ -95,21 +102,37 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
 
     shouldUpdate += hdCam->IsDirty();
 
-    if (shouldUpdate) {
-        hdCam->ApplyCameraSettings(active_camera);
-
-        // Needed for now, as houdini looks through a generated camera
-        // and doesn't copy the projection type (as of 18.0.532)
-        bool is_ortho = round(m_projMtx[3][3]) == 1.0;
-
-        if (is_ortho) {
-            active_camera->type = ccl::CameraType::CAMERA_ORTHOGRAPHIC;
-        } else
-            active_camera->type = ccl::CameraType::CAMERA_PERSPECTIVE;
-
-        active_camera->tag_update();
-
-        renderParam->Interrupt();
+    if (shouldUpdate)
+        m_cameraPending = true;
+
+    if (m_cameraPending) {
+        // The session is not paused for camera edits, it reads the camera
+        // in its scene update under the scene mutex. While it holds the
+        // mutex for a device update the edit waits for the next execution
+        // instead of stalling the draw.
+        std::unique_lock<ccl::thread_mutex> lock(
+            renderParam->GetCyclesScene()->mutex, std::try_to_lock);
+        if (lock.owns_lock()) {
+            hdCam->ApplyCameraSettings(active_camera);
+
+            // Needed for now, as houdini looks through a generated camera
+            // and doesn't copy the projection type (as of 18.0.532)
+            bool is_ortho = round(m_projMtx[3][3]) == 1.0;
+
+            if (is_ortho) {
+                active_camera->type = ccl::CameraType::CAMERA_ORTHOGRAPHIC;
+            } else
+                active_camera->type = ccl::CameraType::CAMERA_PERSPECTIVE;
+
+            active_camera->tag_update();
+            lock.unlock();
+
+            m_cameraPending = false;
+            renderParam->InterruptCamera();
+        } else {
+            // Keeps Hydra drawing until the camera is written
+            m_isConverged = false;
+        }
     }
 
     const auto width     = static_cast<int>(vp[2]);
@@ -118,7 +141,29 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
 
     bool resized = false;
 
-    if (width != m_width || height != m_height) {
+    // The AOVs are reallocated at the new size, the last image is blitted
+    // to them scaled until the session renders at that size
+    const auto now = std::chrono::steady_clock::now();
+    if (width != m_pendingWidth || height != m_pendingHeight) {
+        m_pendingWidth   = width;
+        m_pendingHeight  = height;
+        m_pendingResize  = now;
+        m_displayVersion = 0;
+    }
+
+    // Resets wait for the size to settle, dragging a pane edge would
+    // otherwise restart the render on every draw. The first size and tiled
+    // renders are applied right away.
+    bool applyResize = width != m_width || height != m_height;
+    if (applyResize && m_width != 0 && !renderParam->IsTiledRender()
+        && now - m_pendingResize < m_resizeDelay) {
+        applyResize = false;
+
+        // Keeps Hydra drawing until the resize is applied
+        m_isConverged = false;
+    }
+
+    if (applyResize) {
         const auto oldNumPixels = static_cast<size_t>(m_width * m_height);
         m_width                 = width;
         m_height                = height;
@@ -128,21 +173,27 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
         // before actually rendering at the appropriate size. This seems to be a Cycles
         // issue, however the startup flow of HdCycles has LOTS of room for improvement...
         renderParam->SetViewport(m_width, m_height);
+        m_displayVersion = 0;
 
         // TODO: This is very hacky... But stops the tiled render double render issue...
         if (renderParam->IsTiledRender()) {
             renderParam->StartRender();
         }
 
-        renderParam->Interrupt();
+        // SetViewport already reset the session at the new size, the scene
+        // itself didn't change
 
         if (numPixels != oldNumPixels) {
             resized = true;
         }
     }
 
-    if (renderParam->IsTiledRender())
+    // Tiles finished by the session threads are blitted here, on the Hydra
+    // thread, rather than while readers map the buffers
+    if (renderParam->IsTiledRender()) {
+        renderParam->BlitCompletedTiles();
         return;
+    }
 
     ccl::DisplayBuffer* display = renderParam->GetCyclesSession()->display;
 
@@ -163,6 +214,38 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
     int w = display->draw_width;
     int h = display->draw_height;
 
+    // With a render region the display only holds the region, placed at
+    // full_x, full_y in the full size AOVs
+    const ccl::BufferParams& bufferParams = renderParam->GetBufferParams();
+    const bool isRegion = bufferParams.width != bufferParams.full_width
+                          || bufferParams.height != bufferParams.full_height;
+
+    // Low resolution passes of the region aren't shown, the region is
+    // blitted without resampling
+    if (isRegion && (w != bufferParams.width || h != bufferParams.height)) {
+        return;
+    }
+
+    // Nothing was rendered since the last blit, only the converged state
+    // of the buffers can have changed
+    const uint64_t displayVersion = renderParam->GetDisplayVersion();
+    if (displayVersion == m_displayVersion) {
+        for (auto& aov : aovBindings) {
+            if (aov.renderBuffer) {
+                static_cast<HdCyclesRenderBuffer*>(aov.renderBuffer)
+                    ->SetConverged(m_isConverged);
+            }
+        }
+        return;
+    }
+    m_displayVersion = displayVersion;
+
+    // Full resolution color is read as float with the other passes, the
+    // display only shows the low resolution start passes
+    const bool floatColor = renderParam->IsDisplayBufferFloat()
+                            && w == bufferParams.width
+                            && h == bufferParams.height;
+
     // Blit
     if (!aovBindings.empty()) {
         // Blit from the framebuffer to currently selected aovs...
@@ -174,11 +257,21 @@ HdCyclesRenderPass::_Execute(HdRenderPassStateSharedPtr const& renderPassState,
             auto* rb = static_cast<HdCyclesRenderBuffer*>(aov.renderBuffer);
             rb->SetConverged(m_isConverged);
 
-            if (aov.aovName == HdAovTokens->color) {
-                rb->Blit(colorFormat, w, h, 0, w,
-                         reinterpret_cast<uint8_t*>(hpixels));
+            if (aov.aovName == HdAovTokens->color && !floatColor) {
+                if (isRegion) {
+                    rb->BlitTile(colorFormat, bufferParams.full_x,
+                                 bufferParams.full_y, w, h, 0, w,
+                                 reinterpret_cast<uint8_t*>(hpixels));
+                } else {
+                    rb->Blit(colorFormat, w, h, 0, w,
+                             reinterpret_cast<uint8_t*>(hpixels));
+                }
+                rb->SwapBuffers();
             }
         }
+
+        // The other AOVs are read from the session buffers
+        renderParam->BlitSessionPasses();
     }
 }
 
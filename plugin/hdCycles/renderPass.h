@@ -30,6 +30,8 @@
 #include <pxr/imaging/hd/renderPass.h>
 #include <pxr/pxr.h>
 
+#include <chrono>
+
 PXR_NAMESPACE_OPEN_SCOPE
 
 class HdCyclesRenderDelegate;
@@ -81,6 +83,19 @@ public:
     int m_height = 0;
 
     bool m_isConverged = false;
+
+    // Camera edit not written to the scene yet, the session held the scene
+    // mutex
+    bool m_cameraPending = false;
+
+    // Display version of the last blit, 0 forces the next one
+    uint64_t m_displayVersion = 0;
+
+    // Viewport size waiting to settle before the session is reset to it
+    int m_pendingWidth  = 0;
+    int m_pendingHeight = 0;
+    std::chrono::steady_clock::time_point m_pendingResize;
+    std::chrono::milliseconds m_resizeDelay;
 };
 
 PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,220 @@
+//  Copyright 2020 Tangent Animation
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+//  including without limitation, as related to merchantability and fitness
+//  for a particular purpose.
+//
+//  In no event shall any copyright holder be liable for any damages of any kind
+//  arising from the use of this software, whether in contract, tort or otherwise.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "sessionPool.h"
+
+#include "config.h"
+#include "renderParam.h"
+
+#include <algorithm>
+#include <iterator>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+HdCyclesSessionPool&
+HdCyclesSessionPool::GetInstance()
+{
+    // Never destroyed. Deleting the pooled sessions during static
+    // destruction would join their threads and free their devices after
+    // the statics of Cycles and TBB may be gone, idle sessions are left to
+    // the process exit instead.
+    static HdCyclesSessionPool* instance = new HdCyclesSessionPool();
+    return *instance;
+}
+
+HdCyclesSessionPool::HdCyclesSessionPool()
+{
+    m_enabled = HdCyclesConfig::GetInstance().reuse_session.value;
+}
+
+bool
+HdCyclesSessionPool::_IsCompatible(const ccl::SessionParams& a_lhs,
+                                   const ccl::SessionParams& a_rhs)
+{
+    // Everything a session only reads when it is created. The tile manager
+    // and the display buffer take their settings in their constructors.
+    return a_lhs.device.id == a_rhs.device.id
+           && a_lhs.background == a_rhs.background
+           && a_lhs.threads == a_rhs.threads
+           && a_lhs.shadingsystem == a_rhs.shadingsystem
+           && a_lhs.progressive == a_rhs.progressive
+           && a_lhs.progressive_refine == a_rhs.progressive_refine
+           && a_lhs.tile_size.x == a_rhs.tile_size.x
+           && a_lhs.tile_size.y == a_rhs.tile_size.y
+           && a_lhs.tile_order == a_rhs.tile_order
+           && a_lhs.start_resolution == a_rhs.start_resolution
+           && a_lhs.pixel_size == a_rhs.pixel_size
+           && a_lhs.display_buffer_linear == a_rhs.display_buffer_linear;
+}
+
+bool
+HdCyclesSessionPool::GetDevice(ccl::DeviceType a_type,
+                               ccl::DeviceInfo* a_device)
+{
+    std::lock_guard<std::mutex> lock(m_devicesMutex);
+
+    auto it = m_devices.find(a_type);
+    if (it == m_devices.end()) {
+        std::vector<ccl::DeviceInfo> devices = ccl::Device::available_devices(
+            (ccl::DeviceTypeMask)(1 << a_type));
+
+        ccl::DeviceInfo device;
+        if (!devices.empty())
+            device = devices.front();
+
+        it = m_devices.emplace(a_type, device).first;
+    }
+
+    if (it->second.type == ccl::DEVICE_NONE)
+        return false;
+
+    *a_device = it->second;
+    return true;
+}
+
+void
+HdCyclesSessionPool::_SetOwner(Entry* a_entry, HdCyclesRenderParam* a_owner)
+{
+    std::lock_guard<std::recursive_mutex> lock(a_entry->ownerMutex);
+    a_entry->owner = a_owner;
+}
+
+void
+HdCyclesSessionPool::_BindCallbacks(Entry* a_entry)
+{
+    // Bound once for the lifetime of the session, the entry forwards them
+    // to whichever render param currently owns it.
+    a_entry->session->write_render_tile_cb
+        = [a_entry](ccl::RenderTile& rtile) {
+              std::lock_guard<std::recursive_mutex> lock(a_entry->ownerMutex);
+              if (a_entry->owner)
+                  a_entry->owner->_WriteRenderTile(rtile);
+          };
+    a_entry->session->update_render_tile_cb
+        = [a_entry](ccl::RenderTile& rtile, bool highlight) {
+              std::lock_guard<std::recursive_mutex> lock(a_entry->ownerMutex);
+              if (a_entry->owner)
+                  a_entry->owner->_UpdateRenderTile(rtile, highlight);
+          };
+    a_entry->session->progress.set_update_callback([a_entry]() {
+        std::lock_guard<std::recursive_mutex> lock(a_entry->ownerMutex);
+        if (a_entry->owner)
+            a_entry->owner->_SessionUpdateCallback();
+    });
+}
+
+HdCyclesSessionPool::Entry*
+HdCyclesSessionPool::_FindEntry(ccl::Session* a_session)
+{
+    for (auto& entry : m_entries) {
+        if (entry->session == a_session)
+            return entry.get();
+    }
+    return nullptr;
+}
+
+ccl::Session*
+HdCyclesSessionPool::Acquire(const ccl::SessionParams& a_params,
+                             HdCyclesRenderParam* a_owner, bool* a_isWarm)
+{
+    std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+    for (auto& entry : m_entries) {
+        if (entry->inUse || !_IsCompatible(entry->session->params, a_params))
+            continue;
+
+        entry->inUse           = true;
+        entry->session->params = a_params;
+        _SetOwner(entry.get(), a_owner);
+
+        *a_isWarm = true;
+        return entry->session;
+    }
+
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->session = new ccl::Session(a_params);
+    entry->inUse   = true;
+    entry->owner   = a_owner;
+    _BindCallbacks(entry.get());
+
+    ccl::Session* session = entry->session;
+    m_entries.push_back(std::move(entry));
+
+    *a_isWarm = false;
+    return session;
+}
+
+void
+HdCyclesSessionPool::Start(ccl::Session* a_session)
+{
+    bool started = false;
+    {
+        std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+        Entry* entry = _FindEntry(a_session);
+        if (!entry)
+            return;
+
+        started        = entry->started;
+        entry->started = true;
+    }
+
+    if (started)
+        a_session->set_pause(false);
+    else
+        a_session->start();
+}
+
+void
+HdCyclesSessionPool::Release(ccl::Session* a_session)
+{
+    std::vector<std::unique_ptr<Entry>> expired;
+    {
+        std::lock_guard<std::mutex> lock(m_entriesMutex);
+
+        Entry* entry = _FindEntry(a_session);
+        if (!entry)
+            return;
+
+        _SetOwner(entry, nullptr);
+        entry->inUse = false;
+
+        // Only one idle session is kept, an idle session holds on to the
+        // device memory of its last scene until it is reused.
+        auto keep = [this, entry](const std::unique_ptr<Entry>& e) {
+            if (e->inUse)
+                return true;
+            return m_enabled && e.get() == entry;
+        };
+
+        auto first = std::stable_partition(m_entries.begin(), m_entries.end(),
+                                           keep);
+        std::move(first, m_entries.end(), std::back_inserter(expired));
+        m_entries.erase(first, m_entries.end());
+    }
+
+    // Joining the session threads can take a while, not done under the lock.
+    // The session callbacks point to their entry, it is only freed once the
+    // session thread is gone.
+    for (std::unique_ptr<Entry>& e : expired)
+        delete e->session;
+    expired.clear();
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
@@ -0,0 +1,139 @@
+//  Copyright 2020 Tangent Animation
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+//  including without limitation, as related to merchantability and fitness
+//  for a particular purpose.
+//
+//  In no event shall any copyright holder be liable for any damages of any kind
+//  arising from the use of this software, whether in contract, tort or otherwise.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#ifndef HD_CYCLES_SESSION_POOL_H
+#define HD_CYCLES_SESSION_POOL_H
+
+#include "api.h"
+
+#include <device/device.h>
+#include <render/session.h>
+
+#include <pxr/pxr.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+class HdCyclesRenderParam;
+
+/**
+ * @brief Process wide pool of Cycles sessions
+ * Creating a session creates its device, loads the kernels and spawns the
+ * session thread. A released session is kept paused with an emptied scene,
+ * so the next render delegate, like the next frame of a husk sequence or a
+ * restarted viewport, only has to repopulate the scene.
+ * 
+ * The pool lives until the process exits, the idle session is never
+ * deleted during static destruction.
+ * 
+ */
+class HdCyclesSessionPool {
+public:
+    /**
+     * @return Returns the process wide session pool
+     */
+    HDCYCLES_API
+    static HdCyclesSessionPool& GetInstance();
+
+    /**
+     * @brief Pick the device of the given type. Enumerating the devices
+     * initializes the device backends, so it's done once per device type.
+     * 
+     * @param a_type Type of the device
+     * @param a_device Set to the first device of that type
+     * @return Returns false if no device of that type is available
+     */
+    bool GetDevice(ccl::DeviceType a_type, ccl::DeviceInfo* a_device);
+
+    /**
+     * @brief Hand out a session for the given parameters. An idle session
+     * created with the same device, thread count, background mode, shading
+     * system, tile manager and display settings is reused, a new one is
+     * created otherwise.
+     * 
+     * @param a_params Session parameters, copied into a reused session
+     * @param a_owner Render param receiving the session callbacks
+     * @param a_isWarm Set to true if the session was reused
+     * @return Returns the session
+     */
+    ccl::Session* Acquire(const ccl::SessionParams& a_params,
+                          HdCyclesRenderParam* a_owner, bool* a_isWarm);
+
+    /**
+     * @brief Start the session thread, or resume a reused session
+     * 
+     */
+    void Start(ccl::Session* a_session);
+
+    /**
+     * @brief Hand a session back. The session must be paused and its scene
+     * emptied. Callbacks into the previous owner stop before this returns,
+     * the session is deleted if pooling is disabled.
+     * 
+     */
+    void Release(ccl::Session* a_session);
+
+    /**
+     * @return Returns true if released sessions are kept for reuse
+     */
+    bool IsEnabled() const { return m_enabled; }
+
+private:
+    HdCyclesSessionPool();
+    ~HdCyclesSessionPool() = default;
+
+    HdCyclesSessionPool(const HdCyclesSessionPool&) = delete;
+    HdCyclesSessionPool& operator=(const HdCyclesSessionPool&) = delete;
+
+    struct Entry {
+        ccl::Session* session = nullptr;
+        bool inUse            = false;
+        bool started          = false;
+
+        // Guards owner, held while forwarding a callback so that releasing
+        // waits for callbacks in flight. Recursive as a callback may trigger
+        // a progress update.
+        std::recursive_mutex ownerMutex;
+        HdCyclesRenderParam* owner = nullptr;
+    };
+
+    static bool _IsCompatible(const ccl::SessionParams& a_lhs,
+                              const ccl::SessionParams& a_rhs);
+
+    void _BindCallbacks(Entry* a_entry);
+    void _SetOwner(Entry* a_entry, HdCyclesRenderParam* a_owner);
+    Entry* _FindEntry(ccl::Session* a_session);
+
+    bool m_enabled;
+
+    std::mutex m_entriesMutex;
+    std::vector<std::unique_ptr<Entry>> m_entries;
+
+    // Device picked for each device type, DEVICE_NONE if there is none
+    std::mutex m_devicesMutex;
+    std::map<ccl::DeviceType, ccl::DeviceInfo> m_devices;
+};
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif  // HD_CYCLES_SESSION_POOL_H
@@ -0,0 +1,159 @@
+//  Copyright 2020 Tangent Animation
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+//  including without limitation, as related to merchantability and fitness
+//  for a particular purpose.
+//
+//  In no event shall any copyright holder be liable for any damages of any kind
+//  arising from the use of this software, whether in contract, tort or otherwise.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#include "trace.h"
+
+#include "config.h"
+
+#include <pxr/base/tf/diagnostic.h>
+
+#include <atomic>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+namespace {
+
+// Small, stable thread ids read better in trace viewers than native ones
+uint32_t
+_GetTraceThreadId()
+{
+    static std::atomic<uint32_t> s_nextThreadId(0);
+    thread_local uint32_t threadId = s_nextThreadId++;
+    return threadId;
+}
+
+void
+_WriteJsonString(std::ostream& a_out, const char* a_string)
+{
+    a_out << '"';
+    for (const char* c = a_string; *c; ++c) {
+        switch (*c) {
+        case '"': a_out << "\\\""; break;
+        case '\\': a_out << "\\\\"; break;
+        case '\n': a_out << "\\n"; break;
+        case '\t': a_out << "\\t"; break;
+        default: a_out << *c; break;
+        }
+    }
+    a_out << '"';
+}
+
+}  // namespace
+
+HdCyclesTrace&
+HdCyclesTrace::GetInstance()
+{
+    static HdCyclesTrace instance;
+    return instance;
+}
+
+HdCyclesTrace::HdCyclesTrace()
+    : m_enabled(false)
+    , m_origin(std::chrono::steady_clock::now())
+    , m_hasWrittenEvents(false)
+{
+    const HdCyclesConfig& config = HdCyclesConfig::GetInstance();
+    if (!config.enable_trace)
+        return;
+
+    m_filePath = config.trace_file;
+    m_file.open(m_filePath, std::ios::out | std::ios::trunc);
+    if (!m_file) {
+        TF_WARN("Could not open trace file %s, tracing is disabled.",
+                m_filePath.c_str());
+        return;
+    }
+
+    // The closing bracket is optional in the JSON array format, the trace
+    // stays readable if the process doesn't shut down cleanly.
+    m_file << "[\n";
+    m_enabled = true;
+}
+
+HdCyclesTrace::~HdCyclesTrace()
+{
+    if (!m_enabled)
+        return;
+
+    Flush();
+
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+    m_file << "\n]\n";
+}
+
+void
+HdCyclesTrace::AddEvent(const char* a_name, const SdfPath& a_prim,
+                        std::chrono::steady_clock::time_point a_start,
+                        std::chrono::steady_clock::time_point a_end)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    Event event;
+    event.name     = a_name;
+    event.prim     = a_prim;
+    event.start    = duration_cast<microseconds>(a_start - m_origin).count();
+    event.duration = duration_cast<microseconds>(a_end - a_start).count();
+    event.thread   = _GetTraceThreadId();
+
+    std::lock_guard<std::mutex> lock(m_eventsMutex);
+    m_events.push_back(std::move(event));
+}
+
+void
+HdCyclesTrace::Flush()
+{
+    if (!m_enabled)
+        return;
+
+    std::vector<Event> events;
+    {
+        std::lock_guard<std::mutex> lock(m_eventsMutex);
+        events.swap(m_events);
+    }
+
+    if (events.empty())
+        return;
+
+    std::lock_guard<std::mutex> lock(m_fileMutex);
+
+    for (const Event& event : events) {
+        if (m_hasWrittenEvents)
+            m_file << ",\n";
+        m_hasWrittenEvents = true;
+
+        m_file << "{\"name\":";
+        _WriteJsonString(m_file, event.name);
+        m_file << ",\"cat\":\"hdCycles\",\"ph\":\"X\",\"pid\":1"
+               << ",\"tid\":" << event.thread << ",\"ts\":" << event.start
+               << ",\"dur\":" << event.duration;
+
+        if (!event.prim.IsEmpty()) {
+            m_file << ",\"args\":{\"prim\":";
+            _WriteJsonString(m_file, event.prim.GetText());
+            m_file << '}';
+        }
+
+        m_file << '}';
+    }
+
+    m_file.flush();
+}
+
+PXR_NAMESPACE_CLOSE_SCOPE
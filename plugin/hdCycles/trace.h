@@ -0,0 +1,154 @@
+//  Copyright 2020 Tangent Animation
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+//  including without limitation, as related to merchantability and fitness
+//  for a particular purpose.
+//
+//  In no event shall any copyright holder be liable for any damages of any kind
+//  arising from the use of this software, whether in contract, tort or otherwise.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+#ifndef HD_CYCLES_TRACE_H
+#define HD_CYCLES_TRACE_H
+
+#include "api.h"
+
+#include <pxr/base/tf/preprocessorUtils.h>
+#include <pxr/imaging/hd/perfLog.h>
+#include <pxr/pxr.h>
+#include <pxr/usd/sdf/path.h>
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+PXR_NAMESPACE_OPEN_SCOPE
+
+/**
+ * @brief Collects timed scopes of the Hydra to Cycles conversion and writes
+ * them as a Chrome trace (JSON array format), loadable in chrome://tracing
+ * and Perfetto. Enabled with HD_CYCLES_ENABLE_TRACE, the file is set with
+ * HD_CYCLES_TRACE_FILE.
+ * 
+ */
+class HdCyclesTrace {
+public:
+    /**
+     * @return Returns the process wide trace collector
+     */
+    HDCYCLES_API
+    static HdCyclesTrace& GetInstance();
+
+    /**
+     * @return Returns true if scopes should be recorded
+     */
+    bool IsEnabled() const { return m_enabled; }
+
+    /**
+     * @brief Record a completed scope
+     * 
+     * @param a_name Name of the scope
+     * @param a_prim Prim the scope converted, may be empty
+     * @param a_start Time the scope was entered
+     * @param a_end Time the scope was left
+     */
+    HDCYCLES_API
+    void AddEvent(const char* a_name, const SdfPath& a_prim,
+                  std::chrono::steady_clock::time_point a_start,
+                  std::chrono::steady_clock::time_point a_end);
+
+    /**
+     * @brief Append the events recorded so far to the trace file.
+     * Called once per commit, so the file stays readable while rendering.
+     * 
+     */
+    HDCYCLES_API
+    void Flush();
+
+private:
+    HdCyclesTrace();
+    ~HdCyclesTrace();
+
+    HdCyclesTrace(const HdCyclesTrace&) = delete;
+    HdCyclesTrace& operator=(const HdCyclesTrace&) = delete;
+
+    struct Event {
+        const char* name;
+        SdfPath prim;
+        int64_t start;
+        int64_t duration;
+        uint32_t thread;
+    };
+
+    bool m_enabled;
+    std::string m_filePath;
+    std::chrono::steady_clock::time_point m_origin;
+
+    std::mutex m_eventsMutex;
+    std::vector<Event> m_events;
+
+    std::mutex m_fileMutex;
+    std::ofstream m_file;
+    bool m_hasWrittenEvents;
+};
+
+/**
+ * @brief Times the enclosing scope into HdCyclesTrace. Does nothing but one
+ * branch when tracing is disabled.
+ * 
+ */
+class HdCyclesTraceScope {
+public:
+    explicit HdCyclesTraceScope(const char* a_name,
+                                const SdfPath& a_prim = SdfPath())
+        : m_name(nullptr)
+    {
+        if (HdCyclesTrace::GetInstance().IsEnabled()) {
+            m_name  = a_name;
+            m_prim  = a_prim;
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~HdCyclesTraceScope()
+    {
+        if (m_name) {
+            HdCyclesTrace::GetInstance().AddEvent(
+                m_name, m_prim, m_start, std::chrono::steady_clock::now());
+        }
+    }
+
+    HdCyclesTraceScope(const HdCyclesTraceScope&) = delete;
+    HdCyclesTraceScope& operator=(const HdCyclesTraceScope&) = delete;
+
+private:
+    const char* m_name;
+    SdfPath m_prim;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+// Scopes are also forwarded to the USD trace collector
+
+#define HD_CYCLES_TRACE_SCOPE(name) \
+    HD_TRACE_SCOPE(name);           \
+    HdCyclesTraceScope TF_PP_CAT(_hdCyclesTraceScope, __LINE__)(name)
+
+#define HD_CYCLES_TRACE_PRIM_SCOPE(name, prim) \
+    HD_TRACE_SCOPE(name);                      \
+    HdCyclesTraceScope TF_PP_CAT(_hdCyclesTraceScope, __LINE__)(name, prim)
+
+PXR_NAMESPACE_CLOSE_SCOPE
+
+#endif  // HD_CYCLES_TRACE_H
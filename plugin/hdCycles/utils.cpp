@@ -172,11 +172,25 @@ HdCyclesSetTransform(ccl::Object* object, HdSceneDelegate* delegate,
 
     delegate->SampleTransform(id, &xf);
 
+    HdCyclesSetTransform(object, xf, use_motion);
+
+    return xf;
+}
+
+void
+HdCyclesSetTransform(
+    ccl::Object* object,
+    const HdTimeSampleArray<GfMatrix4d, HD_CYCLES_MOTION_STEPS>& xf,
+    bool use_motion)
+{
+    if (!object)
+        return;
+
     int sampleCount = xf.count;
 
     if (sampleCount == 0) {
         object->tfm = ccl::transform_identity();
-        return xf;
+        return;
     }
 
     if (sampleCount > 1) {
@@ -194,7 +208,7 @@ HdCyclesSetTransform(ccl::Object* object, HdSceneDelegate* delegate,
     }
 
     if (!use_motion) {
-        return xf;
+        return;
     }
 
     object->motion.clear();
@@ -202,7 +216,7 @@ HdCyclesSetTransform(ccl::Object* object, HdSceneDelegate* delegate,
         if (object->geometry->use_motion_blur
             && object->geometry->motion_steps != sampleCount) {
             object->motion.resize(object->geometry->motion_steps, object->tfm);
-            return xf;
+            return;
         }
     }
 
@@ -232,8 +246,6 @@ HdCyclesSetTransform(ccl::Object* object, HdSceneDelegate* delegate,
             object->motion[idx] = mat4d_to_transform(xf.values.data()[i]);
         }
     }
-
-    return xf;
 }
 
 ccl::Transform
@@ -499,6 +511,46 @@ HdCyclesIsPrimvarExists(TfToken const& a_name,
     return false;
 }
 
+size_t
+HdCyclesHashTransformSamples(
+    const HdTimeSampleArray<GfMatrix4d, HD_CYCLES_MOTION_STEPS>& a_samples)
+{
+    size_t hash = a_samples.count;
+    for (size_t i = 0; i < a_samples.count; ++i) {
+        HdCyclesHashCombine(hash, std::hash<float>()(a_samples.times[i]));
+        HdCyclesHashCombine(hash, hash_value(a_samples.values[i]));
+    }
+    return hash;
+}
+
+size_t
+HdCyclesHashPrimvarSamples(const HdCyclesSampledPrimvarType& a_samples)
+{
+    size_t hash = a_samples.count;
+    for (size_t i = 0; i < a_samples.count; ++i) {
+        HdCyclesHashCombine(hash, std::hash<float>()(a_samples.times[i]));
+        HdCyclesHashCombine(hash, a_samples.values[i].GetHash());
+    }
+    return hash;
+}
+
+size_t
+HdCyclesHashMeshTopology(const HdMeshTopology& a_topology)
+{
+    size_t hash = a_topology.GetScheme().Hash();
+    HdCyclesHashCombine(hash, a_topology.GetOrientation().Hash());
+    HdCyclesHashCombine(hash, hash_value(a_topology.GetFaceVertexCounts()));
+    HdCyclesHashCombine(hash, hash_value(a_topology.GetFaceVertexIndices()));
+    HdCyclesHashCombine(hash, hash_value(a_topology.GetHoleIndices()));
+
+    for (const HdGeomSubset& subset : a_topology.GetGeomSubsets()) {
+        HdCyclesHashCombine(hash, subset.id.GetHash());
+        HdCyclesHashCombine(hash, subset.materialId.GetHash());
+        HdCyclesHashCombine(hash, hash_value(subset.indices));
+    }
+    return hash;
+}
+
 /* ========= MikkTSpace ========= */
 
 struct MikkUserData {
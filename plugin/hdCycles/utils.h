@@ -107,6 +107,22 @@ HdTimeSampleArray<GfMatrix4d, HD_CYCLES_MOTION_STEPS>
 HdCyclesSetTransform(ccl::Object* object, HdSceneDelegate* delegate,
                      const SdfPath& id, bool use_motion);
 
+/**
+ * @brief Apply already sampled transforms to a Cycles object
+ * Allows the (scene delegate) sampling to happen apart from the write
+ * to the Cycles object.
+ *
+ * @param object
+ * @param xf Transform samples
+ * @param use_motion
+ */
+HDCYCLES_API
+void
+HdCyclesSetTransform(
+    ccl::Object* object,
+    const HdTimeSampleArray<GfMatrix4d, HD_CYCLES_MOTION_STEPS>& xf,
+    bool use_motion);
+
 ccl::Transform
 HdCyclesExtractTransform(HdSceneDelegate* delegate, const SdfPath& id);
 
@@ -279,6 +295,87 @@ HdCyclesIsPrimvarExists(TfToken const& a_name,
 using HdCyclesSampledPrimvarType
     = HdTimeSampleArray<VtValue, HD_CYCLES_MAX_PRIMVAR_SAMPLES>;
 
+/**
+ * @brief Cycles object pass id of an rprim
+ * 
+ * Offset of 1 added because Cycles primId pass needs to be shifted down to
+ * -1, the primId AOV then reads -1 where no prim was hit. The usdCycles
+ * primvars:cycles:object:pass_id primvar takes precedence over the primId,
+ * it is offset the same way so the AOV reads back the authored value.
+ * 
+ * @param a_primId Hydra prim id of the rprim
+ * @param a_passIdPrimvar Authored pass_id primvar, negative if not authored
+ * @return Pass id of the Cycles objects of the rprim
+ */
+inline int
+HdCyclesGetPassId(int a_primId, int a_passIdPrimvar = -1)
+{
+    if (a_passIdPrimvar >= 0)
+        return a_passIdPrimvar + 1;
+    return a_primId + 1;
+}
+
+/* ========== Hashing ============ */
+
+/**
+ * @brief Mix a hash value into a seed, as boost::hash_combine does
+ * 
+ * @param a_seed Hash to combine into
+ * @param a_value Hash to combine
+ */
+inline void
+HdCyclesHashCombine(size_t& a_seed, size_t a_value)
+{
+    a_seed ^= a_value + 0x9e3779b9 + (a_seed << 6) + (a_seed >> 2);
+}
+
+/**
+ * @brief Store a content hash
+ * 
+ * @param a_hash Stored hash, replaced by a_newHash
+ * @param a_newHash Hash of the incoming data
+ * @return Returns true if the content changed
+ */
+inline bool
+HdCyclesUpdateHash(size_t& a_hash, size_t a_newHash)
+{
+    if (a_hash == a_newHash)
+        return false;
+    a_hash = a_newHash;
+    return true;
+}
+
+/**
+ * @brief Content hash of sampled transforms, times included
+ * 
+ * @param a_samples Transform samples
+ * @return Hash of the samples
+ */
+HDCYCLES_API
+size_t
+HdCyclesHashTransformSamples(
+    const HdTimeSampleArray<GfMatrix4d, HD_CYCLES_MOTION_STEPS>& a_samples);
+
+/**
+ * @brief Content hash of sampled primvar values, times included
+ * 
+ * @param a_samples Primvar samples
+ * @return Hash of the samples
+ */
+HDCYCLES_API
+size_t
+HdCyclesHashPrimvarSamples(const HdCyclesSampledPrimvarType& a_samples);
+
+/**
+ * @brief Content hash of a mesh topology and its geometry subsets
+ * 
+ * @param a_topology Mesh topology
+ * @return Hash of the topology
+ */
+HDCYCLES_API
+size_t
+HdCyclesHashMeshTopology(const HdMeshTopology& a_topology);
+
 /* ======== VtValue Utils ========= */
 
 
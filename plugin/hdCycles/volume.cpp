@@ -24,6 +24,7 @@
 #include "config.h"
 #include "material.h"
 #include "renderParam.h"
+#include "trace.h"
 #include "utils.h"
 
 #include <render/object.h>
@@ -79,12 +80,10 @@ HdCyclesVolume::~HdCyclesVolume()
 {
     if (m_cyclesObject) {
         m_renderDelegate->GetCyclesRenderParam()->RemoveObject(m_cyclesObject);
-        delete m_cyclesObject;
     }
 
     if (m_cyclesVolume) {
         m_renderDelegate->GetCyclesRenderParam()->RemoveMesh(m_cyclesVolume);
-        delete m_cyclesVolume;
     }
 }
 
@@ -133,6 +132,8 @@ HdCyclesVolume::_PopulateVolume(const SdfPath& id, HdSceneDelegate* delegate,
                                 ccl::Scene* scene)
 {
 #ifdef WITH_OPENVDB
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesVolume::_PopulateVolume", id);
+
     std::unordered_map<std::string, std::vector<TfToken>> openvdbs;
     std::unordered_map<std::string, std::vector<TfToken>> houVdbs;
 
@@ -228,12 +229,23 @@ void
 HdCyclesVolume::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
                      HdDirtyBits* dirtyBits, TfToken const& reprSelector)
 {
+    HD_CYCLES_TRACE_PRIM_SCOPE("HdCyclesVolume::Sync", GetId());
+
     SdfPath const& id = GetId();
 
     HdCyclesRenderParam* param = (HdCyclesRenderParam*)renderParam;
 
     ccl::Scene* scene = param->GetCyclesScene();
 
+    // Render tag and repr only changes leave the scene as is
+    if (!(*dirtyBits & GetInitialDirtyBitsMask())) {
+        *dirtyBits = HdChangeTracker::Clean;
+        return;
+    }
+
+    // Volumes edit their object and mesh in place
+    std::unique_lock<ccl::thread_mutex> sceneLock = param->LockScene();
+
     HdCyclesPDPIMap pdpi;
     bool generate_new_curve = false;
     bool update_volumes     = false;
@@ -255,6 +267,11 @@ HdCyclesVolume::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         }
     }
 
+    if (*dirtyBits & HdChangeTracker::DirtyPrimID) {
+        m_cyclesObject->pass_id = HdCyclesGetPassId(GetPrimId());
+        update_volumes          = true;
+    }
+
     if (*dirtyBits & HdChangeTracker::DirtyTransform) {
         m_transformSamples = HdCyclesSetTransform(m_cyclesObject, sceneDelegate,
                                                   id, m_useMotionBlur);
@@ -302,6 +319,7 @@ HdCyclesVolume::Sync(HdSceneDelegate* sceneDelegate, HdRenderParam* renderParam,
         m_cyclesVolume->tag_update(scene, rebuild);
         m_cyclesObject->tag_update(scene);
 
+        param->MarkChanged(HdCyclesRenderParam::GeometryChanged);
         param->Interrupt();
     }
 
@@ -315,7 +333,7 @@ HdCyclesVolume::GetInitialDirtyBitsMask() const
            | HdChangeTracker::DirtyNormals | HdChangeTracker::DirtyWidths
            | HdChangeTracker::DirtyPrimvar | HdChangeTracker::DirtyTransform
            | HdChangeTracker::DirtyVisibility
-           | HdChangeTracker::DirtyMaterialId;
+           | HdChangeTracker::DirtyMaterialId | HdChangeTracker::DirtyPrimID;
 }
 
 bool
@@ -0,0 +1,509 @@
+//  Copyright 2020 Tangent Animation
+//
+//  Licensed under the Apache License, Version 2.0 (the "License");
+//  you may not use this file except in compliance with the License.
+//  You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+//  Unless required by applicable law or agreed to in writing, software
+//  distributed under the License is distributed on an "AS IS" BASIS,
+//  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied,
+//  including without limitation, as related to merchantability and fitness
+//  for a particular purpose.
+//
+//  In no event shall any copyright holder be liable for any damages of any kind
+//  arising from the use of this software, whether in contract, tort or otherwise.
+//  See the License for the specific language governing permissions and
+//  limitations under the License.
+
+// Headless benchmark of the Hydra to Cycles scene sync.
+//
+// Builds a render index with HdCyclesRenderDelegate from a synthetic
+// HdUnitTestDelegate stage and times the first sync, incremental re-syncs
+// and teardown. Results, including the peak RSS, are written as JSON.
+//
+// Only the conversion is measured, the Cycles session is never started.
+
+#include <hdCycles/renderDelegate.h>
+
+#include <pxr/base/gf/matrix4f.h>
+#include <pxr/base/gf/vec3f.h>
+#include <pxr/base/gf/vec4f.h>
+#include <pxr/base/tf/getenv.h>
+#include <pxr/base/tf/setenv.h>
+#include <pxr/base/tf/token.h>
+#include <pxr/imaging/hd/changeTracker.h>
+#include <pxr/imaging/hd/engine.h>
+#include <pxr/imaging/hd/material.h>
+#include <pxr/imaging/hd/renderIndex.h>
+#include <pxr/imaging/hd/renderPass.h>
+#include <pxr/imaging/hd/rprimCollection.h>
+#include <pxr/imaging/hd/task.h>
+#include <pxr/imaging/hd/tokens.h>
+#include <pxr/imaging/hd/unitTestDelegate.h>
+#include <pxr/usd/sdf/path.h>
+
+#ifdef _WIN32
+#    ifndef NOMINMAX
+#        define NOMINMAX
+#    endif
+#    include <windows.h>
+// Needs the types of windows.h
+#    include <psapi.h>
+#else
+#    include <sys/resource.h>
+#endif
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+PXR_NAMESPACE_USING_DIRECTIVE
+
+namespace {
+
+struct BenchmarkOptions {
+    int meshes        = 1000;
+    int faces         = 1000;
+    int instancers    = 10;
+    int instances     = 1000;
+    int curves        = 10;
+    int strands       = 10000;
+    int pointClouds   = 10;
+    int points        = 100000;
+    int materials     = 100;
+    int resyncs       = 10;
+    float resyncRatio = 0.1f;
+    std::string edit  = "points";
+    std::string output;
+};
+
+struct BenchmarkResults {
+    double firstSync = 0.0;
+    std::vector<double> resyncs;
+    double teardown = 0.0;
+    long peakRssKb  = 0;
+};
+
+using Clock = std::chrono::steady_clock;
+
+double
+secondsSince(Clock::time_point a_start)
+{
+    return std::chrono::duration<double>(Clock::now() - a_start).count();
+}
+
+long
+peakRssKb()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters)))
+        return 0;
+    return static_cast<long>(counters.PeakWorkingSetSize / 1024);
+#else
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+#    ifdef __APPLE__
+    // ru_maxrss is in bytes on macOS
+    return usage.ru_maxrss / 1024;
+#    else
+    // ru_maxrss is in kilobytes on Linux
+    return usage.ru_maxrss;
+#    endif
+#endif
+}
+
+void
+printUsage()
+{
+    std::cout
+        << "Usage: hdCyclesSyncBenchmark [options]\n"
+        << "  --meshes N        Number of meshes\n"
+        << "  --faces N         Quads per mesh\n"
+        << "  --instancers N    Number of instancers\n"
+        << "  --instances N     Instances per instancer\n"
+        << "  --curves N        Number of curve prims\n"
+        << "  --strands N       Strands per curve prim\n"
+        << "  --point-clouds N  Number of point clouds\n"
+        << "  --points N        Points per point cloud\n"
+        << "  --materials N     Number of materials\n"
+        << "  --resyncs N       Number of incremental re-syncs\n"
+        << "  --resync-ratio F  Fraction of meshes edited per re-sync\n"
+        << "  --edit MODE       Re-sync edit, points (move and deform) or\n"
+        << "                    transform (move only)\n"
+        << "  --output FILE     Write the JSON results to FILE\n";
+}
+
+bool
+parseOptions(int argc, char** argv, BenchmarkOptions& a_options)
+{
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage();
+            return false;
+        }
+
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << '\n';
+            return false;
+        }
+
+        const char* value = argv[++i];
+        if (arg == "--meshes") {
+            a_options.meshes = std::atoi(value);
+        } else if (arg == "--faces") {
+            a_options.faces = std::atoi(value);
+        } else if (arg == "--instancers") {
+            a_options.instancers = std::atoi(value);
+        } else if (arg == "--instances") {
+            a_options.instances = std::atoi(value);
+        } else if (arg == "--curves") {
+            a_options.curves = std::atoi(value);
+        } else if (arg == "--strands") {
+            a_options.strands = std::atoi(value);
+        } else if (arg == "--point-clouds") {
+            a_options.pointClouds = std::atoi(value);
+        } else if (arg == "--points") {
+            a_options.points = std::atoi(value);
+        } else if (arg == "--materials") {
+            a_options.materials = std::atoi(value);
+        } else if (arg == "--resyncs") {
+            a_options.resyncs = std::atoi(value);
+        } else if (arg == "--resync-ratio") {
+            a_options.resyncRatio = static_cast<float>(std::atof(value));
+        } else if (arg == "--edit") {
+            a_options.edit = value;
+            if (a_options.edit != "points" && a_options.edit != "transform") {
+                std::cerr << "Unknown edit " << a_options.edit << '\n';
+                return false;
+            }
+        } else if (arg == "--output") {
+            a_options.output = value;
+        } else {
+            std::cerr << "Unknown option " << arg << '\n';
+            printUsage();
+            return false;
+        }
+    }
+    return true;
+}
+
+void
+setDefaultEnv(const std::string& a_name, const std::string& a_value)
+{
+    if (TfGetenv(a_name).empty())
+        TfSetenv(a_name, a_value);
+}
+
+// Configuration the delegate reads at startup. Explicit environment values
+// are kept, so a run can still be tuned from the outside.
+void
+setBenchmarkEnvironment()
+{
+    // Keeps the session from starting, only the sync is measured
+    setDefaultEnv("HD_CYCLES_USE_TILED_RENDERING", "1");
+    setDefaultEnv("HD_CYCLES_DEVICE_NAME", "CPU");
+
+    // Commit every sync right away instead of coalescing them
+    setDefaultEnv("HD_CYCLES_INTERRUPT_WINDOW", "0");
+    setDefaultEnv("HD_CYCLES_INTERRUPT_LATENCY", "0");
+}
+
+// -- Synthetic stage
+
+void
+buildGrid(int a_faces, VtVec3fArray& a_points, VtIntArray& a_counts,
+          VtIntArray& a_indices)
+{
+    const int res = std::max(1, static_cast<int>(std::sqrt(a_faces)));
+
+    a_points.reserve((res + 1) * (res + 1));
+    for (int y = 0; y <= res; ++y) {
+        for (int x = 0; x <= res; ++x) {
+            a_points.push_back(GfVec3f(x / float(res), y / float(res),
+                                       0.05f * std::sin(float(x + y))));
+        }
+    }
+
+    a_counts.assign(res * res, 4);
+    a_indices.reserve(res * res * 4);
+    for (int y = 0; y < res; ++y) {
+        for (int x = 0; x < res; ++x) {
+            const int i = y * (res + 1) + x;
+            a_indices.push_back(i);
+            a_indices.push_back(i + 1);
+            a_indices.push_back(i + res + 2);
+            a_indices.push_back(i + res + 1);
+        }
+    }
+}
+
+VtValue
+previewSurface(const SdfPath& a_materialId, int a_index)
+{
+    HdMaterialNode node;
+    node.path       = a_materialId.AppendChild(TfToken("PreviewSurface"));
+    node.identifier = TfToken("UsdPreviewSurface");
+    node.parameters[TfToken("diffuseColor")] = VtValue(
+        GfVec3f((a_index % 7) / 7.0f, (a_index % 5) / 5.0f, 0.5f));
+    node.parameters[TfToken("roughness")] = VtValue(0.5f);
+
+    HdMaterialNetwork network;
+    network.nodes.push_back(node);
+
+    HdMaterialNetworkMap networkMap;
+    networkMap.map[HdMaterialTerminalTokens->surface] = network;
+    networkMap.terminals.push_back(node.path);
+    return VtValue(networkMap);
+}
+
+GfMatrix4f
+placement(int a_index)
+{
+    GfMatrix4f transform(1.0f);
+    transform.SetTranslateOnly(
+        GfVec3f(float(a_index % 100), float(a_index / 100), 0.0f));
+    return transform;
+}
+
+void
+populateStage(HdUnitTestDelegate& a_delegate, const BenchmarkOptions& a_options,
+              std::vector<SdfPath>& a_meshIds)
+{
+    const SdfPath root("/Benchmark");
+
+    std::vector<SdfPath> materialIds;
+    for (int i = 0; i < a_options.materials; ++i) {
+        SdfPath id = root.AppendChild(TfToken("Material" + std::to_string(i)));
+        a_delegate.AddMaterialResource(id, previewSurface(id, i));
+        materialIds.push_back(id);
+    }
+
+    VtVec3fArray points;
+    VtIntArray counts, indices;
+    buildGrid(a_options.faces, points, counts, indices);
+
+    for (int i = 0; i < a_options.meshes; ++i) {
+        SdfPath id = root.AppendChild(TfToken("Mesh" + std::to_string(i)));
+        a_delegate.AddMesh(id, placement(i), points, counts, indices);
+        if (!materialIds.empty())
+            a_delegate.BindMaterial(id, materialIds[i % materialIds.size()]);
+        a_meshIds.push_back(id);
+    }
+
+    // One prototype per instancer
+    for (int i = 0; i < a_options.instancers; ++i) {
+        SdfPath instancerId = root.AppendChild(
+            TfToken("Instancer" + std::to_string(i)));
+        a_delegate.AddInstancer(instancerId);
+
+        VtIntArray prototypeIndex(a_options.instances, 0);
+        VtVec3fArray scale(a_options.instances, GfVec3f(1.0f));
+        VtVec4fArray rotate(a_options.instances, GfVec4f(1, 0, 0, 0));
+        VtVec3fArray translate(a_options.instances);
+        for (int j = 0; j < a_options.instances; ++j)
+            translate[j] = GfVec3f(float(j % 100), float(j / 100), float(i));
+        a_delegate.SetInstancerProperties(instancerId, prototypeIndex, scale,
+                                          rotate, translate);
+
+        a_delegate.AddMesh(instancerId.AppendChild(TfToken("Prototype")),
+                           GfMatrix4f(1.0f), points, counts, indices, false,
+                           instancerId);
+    }
+
+    // Cubic strands of four control points
+    for (int i = 0; i < a_options.curves; ++i) {
+        VtVec3fArray cvs;
+        cvs.reserve(a_options.strands * 4);
+        for (int j = 0; j < a_options.strands; ++j) {
+            GfVec3f base(float(j % 1000) * 0.01f, float(j / 1000) * 0.01f,
+                         float(i));
+            for (int k = 0; k < 4; ++k)
+                cvs.push_back(base + GfVec3f(0.0f, 0.0f, 0.1f * k));
+        }
+
+        a_delegate.AddBasisCurves(
+            root.AppendChild(TfToken("Curves" + std::to_string(i))), cvs,
+            VtIntArray(a_options.strands, 4), VtVec3fArray(),
+            HdTokens->cubic, HdTokens->bSpline,
+            VtValue(GfVec3f(1.0f)), HdInterpolationConstant,
+            VtValue(1.0f), HdInterpolationConstant, VtValue(0.01f),
+            HdInterpolationConstant);
+    }
+
+    for (int i = 0; i < a_options.pointClouds; ++i) {
+        VtVec3fArray positions(a_options.points);
+        for (int j = 0; j < a_options.points; ++j) {
+            positions[j] = GfVec3f(float(j % 1000) * 0.01f,
+                                   float(j / 1000) * 0.01f, float(i));
+        }
+
+        a_delegate.AddPoints(
+            root.AppendChild(TfToken("Points" + std::to_string(i))), positions,
+            VtValue(GfVec3f(1.0f)), HdInterpolationConstant, VtValue(1.0f),
+            HdInterpolationConstant, VtValue(0.01f), HdInterpolationConstant);
+    }
+}
+
+// -- Sync driver
+
+// Syncs every rprim of the index through a render pass, without drawing
+class SyncTask : public HdTask {
+public:
+    explicit SyncTask(HdRenderPassSharedPtr a_renderPass)
+        : HdTask(SdfPath::EmptyPath())
+        , m_renderPass(a_renderPass)
+        , m_renderTags({ HdRenderTagTokens->geometry })
+    {
+    }
+
+    void Sync(HdSceneDelegate*, HdTaskContext*,
+              HdDirtyBits* a_dirtyBits) override
+    {
+        m_renderPass->Sync();
+        *a_dirtyBits = HdChangeTracker::Clean;
+    }
+
+    void Prepare(HdTaskContext*, HdRenderIndex*) override {}
+
+    void Execute(HdTaskContext*) override {}
+
+    const TfTokenVector& GetRenderTags() const override { return m_renderTags; }
+
+private:
+    HdRenderPassSharedPtr m_renderPass;
+    TfTokenVector m_renderTags;
+};
+
+void
+writeResults(std::ostream& a_out, const BenchmarkOptions& a_options,
+             const BenchmarkResults& a_results)
+{
+    double resyncTotal = 0.0;
+    for (double resync : a_results.resyncs)
+        resyncTotal += resync;
+
+    a_out << "{\n"
+          << "  \"scene\": {\n"
+          << "    \"meshes\": " << a_options.meshes << ",\n"
+          << "    \"faces\": " << a_options.faces << ",\n"
+          << "    \"instancers\": " << a_options.instancers << ",\n"
+          << "    \"instances\": " << a_options.instances << ",\n"
+          << "    \"curves\": " << a_options.curves << ",\n"
+          << "    \"strands\": " << a_options.strands << ",\n"
+          << "    \"point_clouds\": " << a_options.pointClouds << ",\n"
+          << "    \"points\": " << a_options.points << ",\n"
+          << "    \"materials\": " << a_options.materials << ",\n"
+          << "    \"resync_ratio\": " << a_options.resyncRatio << ",\n"
+          << "    \"edit\": \"" << a_options.edit << "\"\n"
+          << "  },\n"
+          << "  \"first_sync_seconds\": " << a_results.firstSync << ",\n"
+          << "  \"resync_seconds\": [";
+
+    for (size_t i = 0; i < a_results.resyncs.size(); ++i)
+        a_out << (i ? ", " : "") << a_results.resyncs[i];
+
+    a_out << "],\n"
+          << "  \"resync_mean_seconds\": "
+          << (a_results.resyncs.empty()
+                  ? 0.0
+                  : resyncTotal / a_results.resyncs.size())
+          << ",\n"
+          << "  \"teardown_seconds\": " << a_results.teardown << ",\n"
+          << "  \"peak_rss_kb\": " << a_results.peakRssKb << "\n"
+          << "}\n";
+}
+
+}  // namespace
+
+int
+main(int argc, char** argv)
+{
+    BenchmarkOptions options;
+    if (!parseOptions(argc, argv, options))
+        return 1;
+
+    setBenchmarkEnvironment();
+
+    BenchmarkResults results;
+
+    auto renderDelegate = std::make_unique<HdCyclesRenderDelegate>();
+    std::unique_ptr<HdRenderIndex> renderIndex(
+        HdRenderIndex::New(renderDelegate.get(), HdDriverVector()));
+    auto sceneDelegate = std::make_unique<HdUnitTestDelegate>(
+        renderIndex.get(), SdfPath::AbsoluteRootPath());
+
+    std::vector<SdfPath> meshIds;
+    populateStage(*sceneDelegate, options, meshIds);
+
+    HdRprimCollection collection(HdTokens->geometry,
+                                 HdReprSelector(HdReprTokens->refined));
+    HdTaskSharedPtrVector tasks = { std::make_shared<SyncTask>(
+        renderDelegate->CreateRenderPass(renderIndex.get(), collection)) };
+
+    HdEngine engine;
+
+    // First sync, every prim is converted
+    Clock::time_point start = Clock::now();
+    engine.Execute(renderIndex.get(), &tasks);
+    results.firstSync = secondsSince(start);
+
+    // Incremental re-syncs, a slice of the meshes moves and, unless only
+    // transforms are edited, deforms
+    const bool deform = options.edit == "points";
+    const size_t edited = std::min(
+        meshIds.size(), static_cast<size_t>(std::ceil(
+                            meshIds.size() * std::max(options.resyncRatio,
+                                                      0.0f))));
+    for (int i = 0; i < options.resyncs; ++i) {
+        for (size_t j = 0; j < edited; ++j) {
+            const size_t index = (i * edited + j) % meshIds.size();
+            GfMatrix4f transform = placement(static_cast<int>(index));
+            transform.SetTranslateOnly(transform.ExtractTranslation()
+                                       + GfVec3f(0.0f, 0.0f, 0.1f * (i + 1)));
+            sceneDelegate->UpdateTransform(meshIds[index], transform);
+            if (deform) {
+                sceneDelegate->MarkRprimDirty(meshIds[index],
+                                              HdChangeTracker::DirtyPoints);
+            }
+        }
+
+        start = Clock::now();
+        engine.Execute(renderIndex.get(), &tasks);
+        results.resyncs.push_back(secondsSince(start));
+    }
+
+    // Teardown, in reverse order of creation
+    start = Clock::now();
+    tasks.clear();
+    sceneDelegate.reset();
+    renderIndex.reset();
+    renderDelegate.reset();
+    results.teardown = secondsSince(start);
+
+    results.peakRssKb = peakRssKb();
+
+    if (options.output.empty()) {
+        writeResults(std::cout, options, results);
+    } else {
+        std::ofstream file(options.output);
+        if (!file) {
+            std::cerr << "Could not open " << options.output << '\n';
+            return 1;
+        }
+        writeResults(file, options, results);
+    }
+
+    return 0;
+}